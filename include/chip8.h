@@ -9,19 +9,100 @@
 #include "chip8screen.h"
 #include <stddef.h>
 
+// Behaviours CHIP-8 interpreters disagree on. The default (No quirks) is this interpreter's original behaviour.
+#define CHIP8_QUIRK_SHIFT_VY 0x01 // 8xy6 / 8xyE shift Vy into Vx, instead of shifting Vx
+#define CHIP8_QUIRK_LOAD_STORE_I 0x02 // Fx55 / Fx65 leave I past the last register, instead of unchanged
+#define CHIP8_QUIRK_JUMP_VX 0x04 // Bxnn jumps to xnn + Vx, instead of nnn + V0
+#define CHIP8_QUIRK_CLIP_SPRITES 0x08 // Sprites are clipped at the edges of the screen, instead of wrapping
+#define CHIP8_QUIRK_XO_CHIP 0x10 // XO-CHIP: 64 KB of memory, F000 nnnn, Fn01 planes, 5xy2 / 5xy3 and the audio pattern
+#define CHIP8_QUIRK_SCHIP 0x20 // SUPER-CHIP: 00Cn, 00FB-00FF, Fx30, Fx75 / Fx85 and the big font at 0x50
+#define CHIP8_TOTAL_QUIRK_COMBINATIONS 64
+
+// Traps: Faults of the ROM that the emulator recovers from, instead of aborting (See chip8->trap)
+#define CHIP8_TRAP_MEMORY 0x01 // An address past the addressable memory was accessed, it wrapped around
+#define CHIP8_TRAP_STACK 0x02 // A call overflowed the stack or a return underflowed it, the stack pointer wrapped around
+
+// Functions taking the quirks as a constant, so each instance of the interpreter compiled with them folds the quirk
+// checks away (See CHIP8_INTERPRETER in chip8.c)
+#define CHIP8_SPECIALIZED static inline __attribute__((always_inline))
+
+// A named set of quirks matching a family of interpreters (e.g. "cosmac", "schip")
+struct chip8_quirk_profile {
+    const char* name;
+    unsigned char quirks;
+};
+
 // Anything regarding chip8 internals go here: Memory, registers, screen pixels, keyboard, etc...
+// ==> The memory comes last, so copies only need to go up to the end of the addressable memory (See chip8_copy)
+// ==> The memory is a flexible array: Chips are allocated with room for the memory they need (See CHIP8_SIZE)
 struct chip8 {
-    struct chip8_memory memory;
     struct chip8_stack stack;
     struct chip8_registers registers;
     struct chip8_keyboard keyboard;
     struct chip8_screen screen;
+
+    unsigned int rng; // Random number generator state used by Cxkk (Kept per VM so runs are reproducible)
+    unsigned long cycles; // Total number of instructions executed since chip8_init
+    unsigned char quirks; // CHIP8_QUIRK_* flags, set once after loading a ROM (0 after chip8_init)
+    unsigned char flags[CHIP8_TOTAL_RPL_FLAGS]; // SUPER-CHIP user flags (Fx75 / Fx85)
+    unsigned char audio_pattern[CHIP8_AUDIO_PATTERN_SIZE]; // XO-CHIP sound (F002), played while the sound timer runs
+    unsigned char pitch; // XO-CHIP playback rate of the audio pattern (Fx3A)
+    unsigned char trap; // CHIP8_TRAP_* raised since chip8_init, for the host to report (Not part of save states)
+    void (*run_frame)(struct chip8* chip8); // chip8_run_frame specialized for the quirks, set by chip8_set_quirks
+
+    struct chip8_memory memory;
 };
 
+// Bytes of a chip8 with room for memory_size bytes of memory: CHIP8_MEMORY_SIZE, or CHIP8_XO_MEMORY_SIZE for XO-CHIP
+#define CHIP8_SIZE(memory_size) (offsetof(struct chip8, memory.memory) + (memory_size))
+
+// Returns a chip8 with room for memory_size bytes of memory (See CHIP8_SIZE), initialized by chip8_init, or NULL if out
+// of memory. It is freed with free().
+struct chip8* chip8_new(size_t memory_size);
+
+// Resets the chip8, keeping the capacity of its memory
 void chip8_init(struct chip8* chip8);
 
-void chip8_load(struct chip8* chip8, const char* buffer, size_t size);
+// Returns 0 on success, -1 (Loading nothing) if the ROM does not fit in the memory selected by the quirks
+// (See chip8_set_quirks), so XO-CHIP ROMs over CHIP8_MEMORY_SIZE - CHIP8_PROGRAM_LOAD_ADDRESS bytes need
+// CHIP8_QUIRK_XO_CHIP to be set first
+int chip8_load(struct chip8* chip8, const char* buffer, size_t size);
 
 void chip8_exec(struct chip8* chip8, unsigned short opcode);
 
+// Seeds the random number generator used by Cxkk. Two VMs with the same seed, ROM and input produce identical runs
+void chip8_seed(struct chip8* chip8, unsigned int seed);
+
+// Selects the interpreter matching the given CHIP8_QUIRK_* flags, and the memory size: CHIP8_XO_MEMORY_SIZE with
+// CHIP8_QUIRK_XO_CHIP (Zeroed past CHIP8_MEMORY_SIZE when it is switched on), CHIP8_MEMORY_SIZE otherwise.
+// CHIP8_QUIRK_SCHIP also loads the big font used by Fx30.
+// Returns 0 on success, -1 (Leaving the chip8 untouched) if XO-CHIP memory does not fit in the capacity of the chip8.
+int chip8_set_quirks(struct chip8* chip8, unsigned char quirks);
+
+// Bytes of struct chip8 holding its state: Everything up to the end of the addressable memory
+size_t chip8_size(const struct chip8* chip8);
+
+// Copies the state of src into dst, which needs room for chip8_size(src) bytes but may be uninitialized (e.g. a slot
+// of a buffer of states). The addressable memory of src becomes the capacity of dst.
+void chip8_copy(struct chip8* dst, const struct chip8* src);
+
+// Returns the profile with the given name, or NULL if there is none
+const struct chip8_quirk_profile* chip8_quirk_profile_find(const char* name);
+
+// Returns the profile at the given index, or NULL past the last one (Used to list profiles)
+const struct chip8_quirk_profile* chip8_quirk_profile_get(int index);
+
+// Fetches the instruction the program counter points to, then executes it
+void chip8_step(struct chip8* chip8);
+
+// Executes the given number of instructions, returning how many were executed
+int chip8_run(struct chip8* chip8, int cycles);
+
+// Decrements the delay and sound timers, should be called at 60Hz (Once per frame)
+void chip8_tick_timers(struct chip8* chip8);
+
+// Emulates one 60Hz frame: Executes CHIP8_CYCLES_PER_FRAME instructions (Fast-forwarding over idle loops,
+// see chip8idle.h), then ticks the timers
+void chip8_run_frame(struct chip8* chip8);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,60 @@
+#ifndef CHIP8ANALYSIS_H
+#define CHIP8ANALYSIS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "chip8.h"
+
+// Static analysis of a loaded ROM: Every instruction reachable from CHIP8_PROGRAM_LOAD_ADDRESS is found by following
+// jumps (1nnn), calls (2nnn), skips, returns (00EE) and exits (00FD), and grouped into basic blocks forming a control flow graph.
+// ==> Memory read by Dxyn / Fx65 (And XO-CHIP 5xy3 / F002) and written by Fx33 / Fx55 (And 5xy2) is tracked where
+//     I is known (Set by Annn or F000 nnnn in the same block), which separates code from sprites and tables
+// ==> With XO-CHIP quirks, F000 nnnn is a 4 byte instruction (Skips jump over it as a whole) and sets I to nnnn
+// ==> Anything that limits what can be known ahead of running the ROM is flagged: Writes that may land on code
+//     (Self-modifying ROMs), writes through an unknown I, and computed jumps (Bnnn), whose targets are not followed
+// Code found by the analysis can be decoded once up front instead of as it is first executed.
+
+#define CHIP8_ANALYSIS_CODE 0x01 // First byte of a reachable instruction
+#define CHIP8_ANALYSIS_OPERAND 0x02 // Second byte of a reachable instruction
+#define CHIP8_ANALYSIS_LEADER 0x04 // First instruction of a block
+#define CHIP8_ANALYSIS_CALL_TARGET 0x08 // Start of a subroutine
+#define CHIP8_ANALYSIS_DATA 0x10 // Read as data (Sprites, tables)
+#define CHIP8_ANALYSIS_WRITTEN 0x20 // Written by the program
+
+#define CHIP8_ANALYSIS_MAX_BLOCKS (CHIP8_XO_MEMORY_SIZE / 2)
+
+// A run of instructions that is always executed from start to end
+struct chip8_block {
+    unsigned short start;
+    unsigned short end; // Address past the last instruction
+    unsigned short successors[2]; // Blocks that may run next (A skip or a call has two)
+    unsigned char successor_count;
+    bool returns; // Ends with 00EE
+    bool computed; // Ends with Bnnn, the successor is only known at run time
+};
+
+struct chip8_analysis {
+    unsigned char flags[CHIP8_XO_MEMORY_SIZE]; // CHIP8_ANALYSIS_* for every address
+    size_t memory_size; // Addresses analyzed, the addressable memory of the chip8 (See chip8_memory_size)
+    struct chip8_block blocks[CHIP8_ANALYSIS_MAX_BLOCKS]; // Sorted by start address
+    size_t block_count;
+    size_t instruction_count;
+
+    bool self_modifying; // Some write lands on reachable code
+    bool unknown_writes; // Some Fx33 / Fx55 writes through an I that is not known statically
+    bool computed_jumps; // Some Bnnn is reachable, code only reached through it was not found
+    size_t invalid_count; // Reachable opcodes that are not CHIP-8 instructions (Executed as no-ops)
+};
+
+// Analyzes the ROM in the memory of a chip8 (As loaded by chip8_load). Quirks that change I (Fx55 / Fx65) and
+// XO-CHIP instructions are taken from chip8->quirks.
+void chip8_analyze(const struct chip8* chip8, struct chip8_analysis* analysis);
+
+// Returns the block starting at the given address, or NULL if no block starts there
+const struct chip8_block* chip8_analysis_block(const struct chip8_analysis* analysis, unsigned short address);
+
+// Writes the assembly for an opcode (e.g. "LD V3, 0x1f") to out. Returns false if the opcode is not an instruction.
+// XO-CHIP instructions are included, F000 nnnn shows as "LD I, long" since nnnn is not part of the opcode.
+bool chip8_disassemble(unsigned short opcode, char* out, size_t size);
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef CHIP8AUDIO_H
+#define CHIP8AUDIO_H
+
+#include <stdbool.h>
+#include "SDL.h"
+#include "config.h"
+#include "chip8.h"
+
+// Sound output of the front end. The chip8 beeps for as long as its sound timer is running:
+// ==> XO-CHIP ROMs play their 128 bit audio pattern (F002) in a loop, at the rate set by the pitch (Fx3A)
+// ==> Every other ROM plays a square wave at CHIP8_BEEP_FREQUENCY
+//
+// Samples are generated on SDL's audio thread, from a copy of the pattern and rate that chip8_audio_update
+// refreshes once per frame.
+
+struct chip8_audio {
+    SDL_AudioDeviceID device; // 0 when no audio device could be opened, every call is then a no-op
+    int sample_rate;
+
+    // Shared with the audio thread, only changed with the device locked
+    bool playing;
+    unsigned char pattern[CHIP8_AUDIO_PATTERN_SIZE];
+    double step; // Pattern samples to advance per output sample
+    double position; // Current sample in the pattern, from 0 to CHIP8_AUDIO_PATTERN_SIZE * 8
+};
+
+// Returns 0 on success, -1 if no audio device could be opened (The emulator then simply runs silent).
+// SDL must have been initialized with SDL_INIT_AUDIO.
+int chip8_audio_open(struct chip8_audio* audio);
+
+void chip8_audio_close(struct chip8_audio* audio);
+
+// Starts, stops or changes the sound to match the chip8, call once per frame. Muted silences it regardless of the sound timer.
+void chip8_audio_update(struct chip8_audio* audio, const struct chip8* chip8, bool muted);
+
+#endif
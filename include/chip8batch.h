@@ -0,0 +1,36 @@
+#ifndef CHIP8BATCH_H
+#define CHIP8BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "chip8job.h"
+
+// Sharded multi-process batch runner (POSIX only). Jobs are split over forked worker processes, worker n running
+// every job whose index modulo the number of workers is n. Workers write their results straight into a shared
+// memory mapping, so collecting them needs no pipes, files or copies.
+// ==> A ROM that trips one of the asserts in the core only takes down its worker process. The job it was
+//     running is marked as crashed and a new worker picks the shard up at the next job.
+
+enum chip8_batch_status {
+    CHIP8_BATCH_PENDING,
+    CHIP8_BATCH_RUNNING,
+    CHIP8_BATCH_DONE,
+    CHIP8_BATCH_CRASHED
+};
+
+struct chip8_batch_result {
+    int status; // enum chip8_batch_status
+    unsigned long frames;
+    unsigned long cycles;
+    uint64_t hash; // chip8_hash_state of the final state
+    unsigned char screen[CHIP8_SCREEN_PACKED_SIZE]; // Final screen, see chip8_screen_pack
+};
+
+// Runs every job, workers <= 0 uses one process per core. On success returns 0 and the shared result array
+// (One result per job) in results, which must be released with chip8_batch_free. Returns -1 on failure.
+int chip8_batch_run(struct chip8_job* jobs, size_t count, int workers, struct chip8_batch_result** results);
+
+void chip8_batch_free(struct chip8_batch_result* results, size_t count);
+
+#endif
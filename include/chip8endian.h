@@ -0,0 +1,36 @@
+#ifndef CHIP8ENDIAN_H
+#define CHIP8ENDIAN_H
+
+#include <stdint.h>
+
+// Little endian reads and writes of the file formats (Save states, packs and rewind deltas) and of the hashed input,
+// so the same bytes mean the same thing on every host. Compilers turn each one into a plain load or store on x86.
+
+static inline uint32_t chip8_get16(const unsigned char* p) {
+    return (uint32_t) p[0] | (uint32_t) p[1] << 8;
+}
+
+static inline uint32_t chip8_get32(const unsigned char* p) {
+    return (uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+static inline uint64_t chip8_get64(const unsigned char* p) {
+    return (uint64_t) chip8_get32(p) | (uint64_t) chip8_get32(p + 4) << 32;
+}
+
+static inline void chip8_put16(unsigned char* p, uint32_t val) {
+    p[0] = val & 0xff;
+    p[1] = (val >> 8) & 0xff;
+}
+
+static inline void chip8_put32(unsigned char* p, uint32_t val) {
+    chip8_put16(p, val & 0xffff);
+    chip8_put16(p + 2, val >> 16);
+}
+
+static inline void chip8_put64(unsigned char* p, uint64_t val) {
+    chip8_put32(p, val & 0xffffffff);
+    chip8_put32(p + 4, val >> 32);
+}
+
+#endif
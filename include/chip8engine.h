@@ -0,0 +1,24 @@
+#ifndef CHIP8ENGINE_H
+#define CHIP8ENGINE_H
+
+struct chip8;
+
+// An execution engine is anything that can advance a chip8 by a number of instructions: The reference
+// interpreter (chip8_exec), or any faster path built on top of it. Every engine must leave the chip8 in
+// exactly the same state as the reference interpreter would, which is what the lockstep runner checks.
+struct chip8_engine {
+    const char* name;
+
+    // Executes up to cycles instructions and returns how many were actually executed
+    int (*run)(struct chip8* chip8, int cycles, void* context);
+
+    void* context; // Passed untouched to run (Engine specific data, may be NULL)
+};
+
+// Returns the registered engine with the given name, or NULL if there is none
+const struct chip8_engine* chip8_engine_find(const char* name);
+
+// Returns the engine at the given index of the registry, or NULL past the last one (Used to list engines)
+const struct chip8_engine* chip8_engine_get(int index);
+
+#endif
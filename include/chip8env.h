@@ -0,0 +1,53 @@
+#ifndef CHIP8ENV_H
+#define CHIP8ENV_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "chip8.h"
+
+// Vectorized environment for reinforcement learning (Gym style). Each step applies one action to every instance,
+// emulates one frame, and writes rewards, observations and done flags into buffers owned by the caller.
+// ==> An action is a 16-bit mask of the CHIP8 keys held during the frame (Bit n = key n down)
+// ==> An observation is the bit-packed screen of an instance (CHIP8_SCREEN_PACKED_SIZE bytes, see chip8_screen_pack),
+//     observation i starts at observations + i * CHIP8_SCREEN_PACKED_SIZE
+// ==> The reward is how much the game specific score function went up during the frame
+// Nothing is allocated after chip8_env_init.
+
+// Returns the current score of a game, e.g. read from the memory location the ROM keeps it in
+typedef float (*chip8_env_score_fn)(const struct chip8* chip8, void* user);
+
+struct chip8_envs {
+    size_t count;
+    unsigned char* vms; // count instances, stride bytes apart (Only chip8_size bytes each, see chip8_copy)
+    size_t stride;
+    struct chip8* initial; // State every episode starts from, chip8_size bytes
+    unsigned long* frames; // Frames emulated in the current episode of each instance
+    float* scores; // Score of each instance after its last step
+    unsigned long max_frames; // Episode length, 0 = episodes never end
+
+    chip8_env_score_fn score;
+    void* user;
+
+    // Output buffers, provided by the caller
+    float* rewards;
+    unsigned char* observations;
+    bool* dones;
+};
+
+// Creates count instances starting from initial. Returns 0 on success, -1 if out of memory.
+int chip8_env_init(struct chip8_envs* envs, size_t count, const struct chip8* initial, unsigned long max_frames,
+    float* rewards, unsigned char* observations, bool* dones);
+
+void chip8_env_free(struct chip8_envs* envs);
+
+// Sets the score function rewards are computed from (NULL = every reward is 0)
+void chip8_env_set_score(struct chip8_envs* envs, chip8_env_score_fn score, void* user);
+
+// Starts a new episode on an instance and writes its first observation
+void chip8_env_reset(struct chip8_envs* envs, size_t index);
+
+// Steps the first n instances with actions[0..n-1]. Instances whose episode ended have their done flag set,
+// they keep running until chip8_env_reset is called on them.
+void chip8_env_step(struct chip8_envs* envs, const unsigned short* actions, size_t n);
+
+#endif
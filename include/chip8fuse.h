@@ -0,0 +1,131 @@
+#ifndef CHIP8FUSE_H
+#define CHIP8FUSE_H
+
+#include "chip8.h"
+#include <stdbool.h>
+
+// Superinstructions: Pairs of instructions that show up back to back in the hot loops of the bundled ROMs are
+// executed by a single handler, saving a fetch and a dispatch each time. From traces of c8games (Idle loops
+// excluded, see chip8idle.h), the most frequent pairs are:
+// ==> 3xkk / 4xkk, 1nnn (Conditional jump)
+// ==> 6xkk, Ex9E / ExA1 (Load a key number, then test it)
+// ==> Annn, Dxyn (Point I at a sprite, then draw it)
+// ==> 7xkk, 3xkk / 4xkk (Step a counter, then test it)
+// ==> Fx07, 3xkk / 4xkk (Read the delay timer, then test it)
+// Anything else is executed by the reference interpreter, so the result is always the same as chip8_run.
+
+// Whether opcode is a 3xkk or 4xkk on register x
+CHIP8_SPECIALIZED bool chip8_fuse_is_skip(unsigned short opcode, unsigned char x) {
+    return (opcode & 0xff00) == (0x3000 | x << 8) || (opcode & 0xff00) == (0x4000 | x << 8);
+}
+
+// 3xkk skips if Vx == kk, 4xkk if Vx != kk
+CHIP8_SPECIALIZED bool chip8_fuse_skips(const struct chip8* chip8, unsigned short opcode) {
+    bool equal = chip8->registers.V[(opcode >> 8) & 0x000f] == (opcode & 0x00ff);
+    return (opcode & 0xf000) == 0x3000 ? equal : !equal;
+}
+
+// Executes the instruction the program counter points to if it starts a pair (3xkk, 4xkk, 6xkk, 7xkk, Annn or Fx07),
+// and the next one too if they are fused and cycles allows for it. Returns the number of instructions executed (1 or
+// 2), or 0 (Leaving the chip8 untouched) for any other instruction. Takes the quirks as a constant, so each frame
+// runner of chip8.c gets its own copy.
+CHIP8_SPECIALIZED int chip8_fuse_pair(struct chip8* chip8, int cycles, const unsigned int quirks) {
+    // XO-CHIP skips may jump over a 4 byte F000 nnnn, which none of the fused pairs account for
+    unsigned short pc = chip8->registers.PC;
+    if ((quirks & CHIP8_QUIRK_XO_CHIP) || cycles < 2 || pc + 4 > CHIP8_MEMORY_SIZE) {
+        return 0;
+    }
+
+    const unsigned char* code = &chip8->memory.memory[pc];
+    unsigned short first = code[0] << 8 | code[1];
+    unsigned short second = code[2] << 8 | code[3];
+    unsigned char x = (first >> 8) & 0x000f;
+    unsigned char kk = first & 0x00ff;
+    int executed = 1;
+
+    switch (first & 0xf000) {
+        // 3xkk / 4xkk, 1nnn - When the skip is not taken, the jump is executed right away
+        case 0x3000:
+        case 0x4000:
+            if (chip8_fuse_skips(chip8, first)) {
+                chip8->registers.PC = pc + 4;
+            } else if ((second & 0xf000) == 0x1000) {
+                chip8->registers.PC = second & 0x0fff;
+                executed = 2;
+            } else {
+                chip8->registers.PC = pc + 2;
+            }
+        break;
+
+        // 6xkk, Ex9E / ExA1 - The key tested is kk
+        case 0x6000:
+            chip8->registers.V[x] = kk;
+            chip8->registers.PC = pc + 2;
+            if ((second & 0xff00) == (0xE000 | x << 8) && ((second & 0x00ff) == 0x9E || (second & 0x00ff) == 0xA1)) {
+                bool down = chip8_keyboard_is_down(&chip8->keyboard, kk);
+                bool skip = (second & 0x00ff) == 0x9E ? down : !down;
+                chip8->registers.PC = pc + (skip ? 6 : 4);
+                executed = 2;
+            }
+        break;
+
+        // 7xkk, 3xkk / 4xkk
+        case 0x7000:
+            chip8->registers.V[x] += kk;
+            chip8->registers.PC = pc + 2;
+            if (chip8_fuse_is_skip(second, x)) {
+                chip8->registers.PC = pc + (chip8_fuse_skips(chip8, second) ? 6 : 4);
+                executed = 2;
+            }
+        break;
+
+        // Annn, Dxyn
+        case 0xA000:
+            chip8->registers.I = first & 0x0fff;
+            chip8->registers.PC = pc + 2;
+            // A sprite running past the end of memory is left to chip8_exec, which wraps it around
+            if ((second & 0xf000) == 0xD000 && chip8->registers.I + 32 <= CHIP8_MEMORY_SIZE) {
+                const char* sprite = (const char*) &chip8->memory.memory[chip8->registers.I];
+                int vx = chip8->registers.V[(second >> 8) & 0x000f];
+                int vy = chip8->registers.V[(second >> 4) & 0x000f];
+                if (quirks & CHIP8_QUIRK_CLIP_SPRITES) {
+                    chip8->registers.V[0x0f] = chip8_screen_draw_sprite_clipped(&chip8->screen, vx, vy, sprite, second & 0x000f);
+                } else {
+                    chip8->registers.V[0x0f] = chip8_screen_draw_sprite(&chip8->screen, vx, vy, sprite, second & 0x000f);
+                }
+                chip8->registers.PC = pc + 4;
+                executed = 2;
+            }
+        break;
+
+        // Fx07, 3xkk / 4xkk
+        case 0xF000:
+            if (kk != 0x07) {
+                return 0;
+            }
+
+            chip8->registers.V[x] = chip8->registers.delay_timer;
+            chip8->registers.PC = pc + 2;
+            if (chip8_fuse_is_skip(second, x)) {
+                chip8->registers.PC = pc + (chip8_fuse_skips(chip8, second) ? 6 : 4);
+                executed = 2;
+            }
+        break;
+
+        default:
+            return 0;
+    }
+
+    chip8->cycles += executed;
+    return executed;
+}
+
+// Executes the instruction the program counter points to, or the pair starting there if it is fused and
+// cycles allows for it. Returns the number of instructions executed (1 or 2). Same as chip8_fuse_pair with
+// chip8->quirks, then chip8_step if it executed nothing.
+int chip8_fuse_step(struct chip8* chip8, int cycles);
+
+// Same as chip8_run, executing fused pairs in a single dispatch
+int chip8_fuse_run(struct chip8* chip8, int cycles);
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef CHIP8HASH_H
+#define CHIP8HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+struct chip8;
+
+// Fast non-cryptographic 64-bit hash (Same algorithm as xxHash64). Hashing a whole chip8 takes a few
+// microseconds, so it can be done every frame to detect desyncs and regressions without storing full states.
+uint64_t chip8_hash(const void* data, size_t size, uint64_t seed);
+
+// Hashes the memory, registers, stack, keyboard, screen and random number generator of a chip8
+uint64_t chip8_hash_state(const struct chip8* chip8);
+
+// Writes one line "<frame> <hash>" to a hash stream. Streams of two builds can be compared with diff/cmp.
+void chip8_hash_stream_write(FILE* f, unsigned long frame, uint64_t hash);
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef CHIP8IDLE_H
+#define CHIP8IDLE_H
+
+#include "chip8.h"
+#include <stdbool.h>
+
+// Most games spend a large part of every frame waiting: For the delay timer to run out, or for a key. Nothing
+// they execute while waiting changes the state (Apart from the instruction count) until the timers tick or
+// the keys change, and both only happen between chip8_run calls. So once an idle loop is recognized, the rest
+// of the run can be accounted for without executing it, and the chip8 ends up exactly as if it had been.
+// Recognized loops (p being the address of the first instruction):
+// ==> 1nnn with nnn = p (Jump to itself), and 00FD (SUPER-CHIP exit)
+// ==> Fx0A with no key down (Executed again until a key is down)
+// ==> Fx07, 3xkk or 4xkk, 1nnn with nnn = p (Polling the delay timer)
+// ==> Ex9E or ExA1, 1nnn with nnn = p (Polling a key)
+
+// Length of the longest loop recognized, in bytes
+#define CHIP8_IDLE_MAX_LOOP 6
+
+CHIP8_SPECIALIZED bool chip8_idle_any_key_down(struct chip8* chip8) {
+    for (int i = 0; i < CHIP8_TOTAL_KEYS; i++) {
+        if (chip8_keyboard_is_down(&chip8->keyboard, i)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Whether a key poll (Ex9E or ExA1) lets the loop jump back, i.e. does not skip the jump
+CHIP8_SPECIALIZED bool chip8_idle_key_loops(struct chip8* chip8, unsigned short opcode) {
+    unsigned char key = chip8->registers.V[(opcode >> 8) & 0x000f];
+    if (key >= CHIP8_TOTAL_KEYS) {
+        return false;
+    }
+
+    bool down = chip8_keyboard_is_down(&chip8->keyboard, key);
+    return (opcode & 0x00ff) == 0x9E ? !down : down;
+}
+
+// Returns the number of instructions in the idle loop starting at the program counter, if it is going to loop
+// again, and 0 otherwise
+CHIP8_SPECIALIZED int chip8_idle_loop(struct chip8* chip8, const unsigned int quirks) {
+    unsigned short pc = chip8->registers.PC;
+    if ((unsigned int) pc + CHIP8_IDLE_MAX_LOOP > chip8->memory.mask + 1) {
+        return 0;
+    }
+
+    // Every loop starts with a 00FD, 1nnn, Exkk or Fxkk, anything else is let through after a single check
+    const unsigned char* code = &chip8->memory.memory[pc];
+    if (code[0] != 0x00 && (code[0] >> 4) != 0x1 && (code[0] >> 4) != 0xE && (code[0] >> 4) != 0xF) {
+        return 0;
+    }
+
+    unsigned short first = code[0] << 8 | code[1];
+    unsigned short second = code[2] << 8 | code[3];
+    unsigned short third = code[4] << 8 | code[5];
+    unsigned short jump_back = 0x1000 | pc;
+    unsigned char x = (first >> 8) & 0x000f;
+
+    // 1nnn jumping to itself, 00FD (SUPER-CHIP only) and Fx0A with no key down all execute again forever
+    if (first == jump_back || (first == 0x00FD && (quirks & CHIP8_QUIRK_SCHIP)) || ((first & 0xf0ff) == 0xF00A && !chip8_idle_any_key_down(chip8))) {
+        return 1;
+    }
+
+    // Ex9E / ExA1 followed by a jump back to it, looping while the key is in the same state
+    if ((first & 0xf0ff) == 0xE09E || (first & 0xf0ff) == 0xE0A1) {
+        return second == jump_back && chip8_idle_key_loops(chip8, first) ? 2 : 0;
+    }
+
+    // Fx07 then 3xkk / 4xkk on the same register, followed by a jump back to the Fx07. Within a run the delay
+    // timer does not change, so the skip goes the same way every iteration.
+    if ((first & 0xf0ff) == 0xF007 && third == jump_back && ((second & 0xff00) == (0x3000 | x << 8) || (second & 0xff00) == (0x4000 | x << 8))) {
+        unsigned char kk = second & 0x00ff;
+        bool equal = chip8->registers.delay_timer == kk;
+        return ((second & 0xf000) == 0x3000 ? !equal : equal) ? 3 : 0;
+    }
+
+    return 0;
+}
+
+// Same as chip8_idle_skip, taking the quirks as a constant (Inlined into each frame runner of chip8.c)
+CHIP8_SPECIALIZED int chip8_idle_skip_quirks(struct chip8* chip8, int cycles, const unsigned int quirks) {
+    int length = chip8_idle_loop(chip8, quirks);
+    if (length == 0) {
+        return 0;
+    }
+
+    int skipped = cycles - cycles % length;
+
+    // The only 3 instruction loop is the delay timer poll, whose Fx07 leaves the timer in Vx
+    if (length == 3 && skipped > 0) {
+        chip8->registers.V[chip8->memory.memory[chip8->registers.PC] & 0x0f] = chip8->registers.delay_timer;
+    }
+
+    chip8->cycles += skipped;
+    return skipped;
+}
+
+// If the program counter is at the start of an idle loop that will keep looping for the next cycles
+// instructions, fast-forwards over as many whole iterations as fit and returns the number of instructions
+// skipped. Returns 0 (And leaves the chip8 untouched) otherwise.
+int chip8_idle_skip(struct chip8* chip8, int cycles);
+
+// Returns true if the chip8 is in an idle loop with both timers stopped. Such a loop only ends when the keys change
+// (Or never does), so until then running frames would only add to the instruction count.
+bool chip8_idle_waiting(struct chip8* chip8);
+
+// Same as chip8_run, fast-forwarding over idle loops. Everything else goes through chip8_fuse_step.
+int chip8_idle_run(struct chip8* chip8, int cycles);
+
+#endif
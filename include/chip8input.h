@@ -0,0 +1,39 @@
+#ifndef CHIP8INPUT_H
+#define CHIP8INPUT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "chip8keyboard.h"
+
+// An input script is a recording of key presses/releases, each tagged with the frame it happens on.
+// Replaying the same script against the same ROM and seed always produces the same run, which is what
+// headless tools (Differential testing, batch runs, benchmarks) rely on.
+//
+// Script files are plain text, one event per line: <frame> <key> <d|u>
+// ==> frame is a decimal frame number, key is a CHIP8 hex key (0 - F), d = key down, u = key up
+// ==> Lines starting with # are comments. Events must be sorted by frame.
+
+struct chip8_input_event {
+    unsigned long frame;
+    unsigned char key;
+    bool down;
+};
+
+struct chip8_input_script {
+    struct chip8_input_event* events;
+    size_t count;
+    size_t next; // Index of the next event to be applied
+};
+
+// Returns 0 on success, -1 if the file could not be read or is malformed
+int chip8_input_script_load(struct chip8_input_script* script, const char* filename);
+
+void chip8_input_script_free(struct chip8_input_script* script);
+
+// Starts replaying the script from the beginning again
+void chip8_input_script_rewind(struct chip8_input_script* script);
+
+// Applies every event scheduled on or before the given frame to the keyboard
+void chip8_input_script_apply(struct chip8_input_script* script, struct chip8_keyboard* keyboard, unsigned long frame);
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef CHIP8JOB_H
+#define CHIP8JOB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "chip8.h"
+#include "chip8input.h"
+
+// A job is one headless emulator run: A chip8 with a ROM loaded, the input script to replay, and a budget in
+// frames and/or instructions. Batch runners execute many jobs, possibly in slices spread over several threads.
+//
+// Job files list one job per line: <rom> <frames> [cycles] [input script]
+// ==> cycles is an instruction budget (0 = only limited by frames), - as the input script means no input
+// ==> rom is a file name, or <pack>:<name> for a ROM of a pack (See chip8pack.h), run with the quirks stored for it
+// ==> Lines starting with # are comments
+
+struct chip8_job {
+    char* rom;
+    struct chip8* chip8; // Allocated with room for the memory its quirks select (See chip8_new)
+    struct chip8_input_script input;
+
+    unsigned long max_frames;
+    unsigned long max_cycles; // 0 = No instruction budget
+    unsigned long frame; // Frames emulated so far
+    bool done;
+};
+
+// Loads every job of a job file, returns 0 on success or -1 if the file, a ROM or an input script can not be read
+int chip8_jobs_load(const char* filename, struct chip8_job** jobs, size_t* count);
+
+void chip8_jobs_free(struct chip8_job* jobs, size_t count);
+
+// Emulates up to frames more frames of the job. Returns true once the job used up its budget.
+bool chip8_job_run(struct chip8_job* job, unsigned long frames);
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef CHIP8LOCKSTEP_H
+#define CHIP8LOCKSTEP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "chip8.h"
+#include "chip8engine.h"
+#include "chip8input.h"
+
+// The lockstep runner executes two engines side by side from the same starting state and input, comparing
+// registers, memory, stack, keyboard and screen after every block of instructions. When the states differ,
+// the block is replayed one instruction at a time so the exact instruction that diverged is reported.
+
+#define CHIP8_LOCKSTEP_TRACE_LENGTH 32 // Number of instructions kept in the trace leading up to a divergence
+
+struct chip8_lockstep_trace {
+    unsigned long cycle;
+    unsigned short PC;
+    unsigned short opcode;
+};
+
+struct chip8_lockstep_result {
+    bool diverged;
+    unsigned long frame; // Frame in which the divergence happened
+    char what[64]; // Description of the first differing piece of state (e.g. "V[3]", "memory[0x2a4]")
+
+    // State of both engines right after the diverging instruction (Or at the end of the run if none diverged)
+    struct chip8* a;
+    struct chip8* b;
+    unsigned char* states; // a, b and their states at the start of the current block, allocated by chip8_lockstep_run
+
+    // Last instructions executed by engine a, oldest first. The last entry is the instruction that diverged.
+    struct chip8_lockstep_trace trace[CHIP8_LOCKSTEP_TRACE_LENGTH];
+    int trace_count;
+    int trace_start;
+};
+
+// Compares two chip8 states. Returns true if they are identical, otherwise describes the first difference in what
+bool chip8_lockstep_compare(const struct chip8* a, const struct chip8* b, char* what, size_t what_size);
+
+// Runs both engines for the given number of frames, comparing them every block instructions (1 = every instruction).
+// input may be NULL. Returns 1 if the engines diverged, 0 if they agreed (The details are written to result),
+// -1 if out of memory. The result is released with chip8_lockstep_free.
+int chip8_lockstep_run(const struct chip8* initial, const struct chip8_engine* a, const struct chip8_engine* b,
+    struct chip8_input_script* input, unsigned long frames, int block, struct chip8_lockstep_result* result);
+
+void chip8_lockstep_free(struct chip8_lockstep_result* result);
+
+void chip8_lockstep_report(const struct chip8_lockstep_result* result, const struct chip8_engine* a, const struct chip8_engine* b, FILE* out);
+
+#endif
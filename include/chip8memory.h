@@ -1,16 +1,31 @@
 #ifndef CHIP8MEMORY_H
 #define CHIP8MEMORY_H
 
+#include <stddef.h>
 #include "config.h"
 
+struct chip8;
+
+// mask + 1 bytes are addressable: CHIP8_MEMORY_SIZE for plain CHIP-8 and SUPER-CHIP, CHIP8_XO_MEMORY_SIZE for XO-CHIP
+// (See chip8_set_quirks), out of the capacity allocated along with the chip8 (See chip8_new)
+// ==> The memory is a flexible array, so a plain chip8 only takes 4 KB of it, and comes last so a chip8 can be copied
+//     up to the end of its addressable memory (See chip8_copy)
 struct chip8_memory {
-    unsigned char memory[CHIP8_MEMORY_SIZE]; // Chip8 memory size is 4 KB = 4,096 bits
+    unsigned int mask;
+    unsigned int capacity; // Bytes of memory allocated, at least CHIP8_MEMORY_SIZE
+    unsigned char memory[];
 };
 
-void chip8_memory_set(struct chip8_memory* memory, int index, unsigned char val);
+// Number of addressable bytes
+size_t chip8_memory_size(const struct chip8_memory* memory);
+
+// Addresses past the addressable memory wrap around (e.g. 12-bit masking for plain CHIP-8) and raise
+// CHIP8_TRAP_MEMORY, so a ROM indexing past 0xFFF through I never takes the process down. Debug builds assert first,
+// to stop right at the faulty access.
+void chip8_memory_set(struct chip8* chip8, int index, unsigned char val);
 
-unsigned char chip8_memory_get(struct chip8_memory* memory, int index);
+unsigned char chip8_memory_get(struct chip8* chip8, int index);
 
-unsigned short chip8_memory_get_short(struct chip8_memory* memory, int index);
+unsigned short chip8_memory_get_short(struct chip8* chip8, int index);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,63 @@
+#ifndef CHIP8PACK_H
+#define CHIP8PACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "chip8rom.h"
+
+// A pack is a ROM library in a single file: Every ROM with its metadata, and a hash index to find them by name or by
+// content hash (chip8_hash of the ROM, seed 0). It is opened once with chip8_rom_open (One mapping for the whole
+// library), lookups are a couple of probes into the mapped index and ROM data is loaded straight out of the mapping.
+//
+// Layout (Version 1, every value little endian):
+//   "C8PK" magic, u16 version, u16 0, u32 ROM count, u32 buckets (A power of two)
+//   entries[count], CHIP8_PACK_ENTRY_SIZE bytes each:
+//     u64 content hash, u64 name hash, u32 data offset, u32 data size, u32 name offset, u16 name length, u8 quirks,
+//     u8 0, u16 instructions per second, keys[CHIP8_TOTAL_KEYS], 0 up to CHIP8_PACK_ENTRY_SIZE
+//   u32 content index[buckets], u32 name index[buckets]
+//   names (Each followed by a 0), ROM data
+// ==> Both indexes are open addressing tables (Linear probing from hash & (buckets - 1)) holding entry number + 1,
+//     0 marking an empty bucket
+// ==> ROMs with the same content are stored once, their entries share the data
+// ==> Offsets are from the start of the file
+
+#define CHIP8_PACK_VERSION 1
+#define CHIP8_PACK_HEADER_SIZE 16
+#define CHIP8_PACK_ENTRY_SIZE 64
+
+// A ROM of a pack, with the metadata a launcher needs to run it
+struct chip8_pack_rom {
+    const char* name;
+    const char* data;
+    size_t size;
+    uint64_t hash;
+    unsigned char quirks; // CHIP8_QUIRK_* to set before chip8_load
+    unsigned int ips; // Recommended instructions per second
+    char keys[CHIP8_TOTAL_KEYS]; // Host key of every CHIP8 key (See chip8_keyboard_set_map)
+};
+
+struct chip8_pack {
+    struct chip8_rom file;
+    size_t count;
+    size_t buckets;
+};
+
+// Returns 0 on success, -1 if the file could not be mapped or is not a valid pack
+int chip8_pack_open(struct chip8_pack* pack, const char* filename);
+
+void chip8_pack_close(struct chip8_pack* pack);
+
+// Returns 0 and fills rom with the ROM at the given index (0 to count - 1), -1 if out of range or corrupt.
+// Name and data point into the mapping, they stay valid until chip8_pack_close.
+int chip8_pack_get(const struct chip8_pack* pack, size_t index, struct chip8_pack_rom* rom);
+
+// Same as chip8_pack_get, by name or by content hash. Returns -1 if there is no such ROM.
+int chip8_pack_find_name(const struct chip8_pack* pack, const char* name, struct chip8_pack_rom* rom);
+
+int chip8_pack_find_hash(const struct chip8_pack* pack, uint64_t hash, struct chip8_pack_rom* rom);
+
+// Writes a pack holding count ROMs (Their hash field is ignored, it is computed). Returns 0 on success, -1 otherwise.
+int chip8_pack_write(const char* filename, const struct chip8_pack_rom* roms, size_t count);
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef CHIP8PLATFORM_H
+#define CHIP8PLATFORM_H
+
+#include <stdint.h>
+
+// Host services the front end needs from the operating system, implemented with POSIX calls on Linux (And other
+// Unix systems) and with the Win32 API on Windows. Everything else in the emulator is plain C and SDL.
+
+#define CHIP8_NANOSECONDS_PER_SECOND 1000000000ull
+
+// Nanoseconds on a monotonic clock, counted from an arbitrary starting point. Never goes back, not even
+// when the wall clock is changed.
+uint64_t chip8_platform_now(void);
+
+// Sleeps until chip8_platform_now() reaches the deadline, returns right away if it already has.
+// Sleeping until an absolute deadline (Rather than for a duration) keeps frames evenly paced, since the time
+// spent emulating and drawing the frame, and any oversleep of the previous frame, is not added on top.
+void chip8_platform_sleep_until(uint64_t deadline);
+
+#endif
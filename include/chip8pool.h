@@ -0,0 +1,59 @@
+#ifndef CHIP8POOL_H
+#define CHIP8POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+struct chip8;
+
+// A pool runs many chip8 instances at once. Instead of an array of struct chip8, the pool stores every piece of
+// state in its own array indexed by instance (Structure of arrays), e.g. register V3 of all instances is one
+// contiguous array. Stepping every instance one instruction at a time then walks through memory linearly,
+// and the same register of neighbouring instances can be processed together.
+// ==> Screens are stored with 1 bit per pixel, one 64-bit word per row (Leftmost pixel in the highest bit)
+// ==> Keys are stored as a 16-bit mask per instance (Bit n = key n is down)
+// ==> Instances always run the default quirk profile, plain CHIP-8 (chip8->quirks is not copied in or out). Chips with
+//     any quirk, SUPER-CHIP and XO-CHIP included, are refused by chip8_pool_set rather than run differently.
+
+// Memories are a cache line apart on top of their size. At exactly CHIP8_MEMORY_SIZE apart, the same address of every
+// instance maps to the same cache set, and instances running the same code evict each other on every fetch.
+#define CHIP8_POOL_MEMORY_STRIDE (CHIP8_MEMORY_SIZE + 64)
+
+struct chip8_pool {
+    size_t count;
+
+    unsigned char* V; // V[r * count + i] = register Vr of instance i
+    unsigned short* I;
+    unsigned short* PC;
+    unsigned short* SP;
+    unsigned char* delay_timer;
+    unsigned char* sound_timer;
+    unsigned short* stack; // stack[depth * count + i]
+    unsigned short* keys;
+    unsigned int* rng;
+    unsigned long* cycles;
+    unsigned char* trap; // CHIP8_TRAP_* raised by each instance
+    uint64_t* screen; // screen[i * CHIP8_HEIGHT + y] = row y of instance i
+    unsigned char* memory; // memory[i * CHIP8_POOL_MEMORY_STRIDE + address]
+};
+
+// Returns 0 on success, -1 if out of memory. Every instance starts as a freshly initialized chip8 (chip8_init).
+int chip8_pool_init(struct chip8_pool* pool, size_t count);
+
+void chip8_pool_free(struct chip8_pool* pool);
+
+// Copies a chip8 into/out of the pool. The keyboard map of the chip8 is not part of the pool and is left untouched.
+// chip8_pool_set returns 0 on success, -1 (Leaving the instance untouched) if the chip8 has quirks or a high
+// resolution screen, which the pool does not implement.
+int chip8_pool_set(struct chip8_pool* pool, size_t index, const struct chip8* chip8);
+
+void chip8_pool_get(const struct chip8_pool* pool, size_t index, struct chip8* chip8);
+
+// Executes the given number of instructions on every instance
+void chip8_pool_run(struct chip8_pool* pool, int cycles);
+
+// Emulates one 60Hz frame on every instance (Same as chip8_run_frame)
+void chip8_pool_run_frame(struct chip8_pool* pool);
+
+#endif
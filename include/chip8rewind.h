@@ -0,0 +1,48 @@
+#ifndef CHIP8REWIND_H
+#define CHIP8REWIND_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "chip8savestate.h"
+
+struct chip8;
+
+// The rewind buffer keeps one snapshot per frame, oldest snapshots being dropped once the memory budget is used up.
+// ==> Every keyframe_interval frames a full save state is stored (Keyframe)
+// ==> Every other frame only stores the XOR of its save state against the last keyframe, run length encoded.
+//     Between two frames only a handful of bytes of memory and screen change, so most deltas are a few dozen bytes.
+
+struct chip8_rewind_entry {
+    unsigned char* data;
+    size_t size;
+    bool keyframe;
+};
+
+struct chip8_rewind {
+    struct chip8_rewind_entry* entries; // Ring of snapshots, oldest at start
+    size_t capacity;
+    size_t start;
+    size_t count;
+
+    size_t used; // Bytes used by all snapshots
+    size_t budget;
+
+    int keyframe_interval;
+    int since_keyframe; // Snapshots pushed since the last keyframe
+
+    unsigned char keyframe[CHIP8_SAVE_STATE_SIZE]; // Last keyframe, deltas are taken against it
+    size_t keyframe_size;
+    unsigned char scratch[CHIP8_SAVE_STATE_SIZE * 2];
+};
+
+void chip8_rewind_init(struct chip8_rewind* rewind, size_t budget, int keyframe_interval);
+
+void chip8_rewind_free(struct chip8_rewind* rewind);
+
+// Stores a snapshot of the chip8. Returns 0 on success, -1 if out of memory.
+int chip8_rewind_push(struct chip8_rewind* rewind, const struct chip8* chip8);
+
+// Restores the chip8 to the most recent snapshot and removes it. Returns -1 if there is nothing left to rewind.
+int chip8_rewind_pop(struct chip8_rewind* rewind, struct chip8* chip8);
+
+#endif
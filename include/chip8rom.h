@@ -0,0 +1,21 @@
+#ifndef CHIP8ROM_H
+#define CHIP8ROM_H
+
+#include <stddef.h>
+
+// A ROM file mapped read-only into memory (mmap, or a file mapping on Windows) instead of being read into a buffer.
+// The pages are shared with the OS file cache and with every other process mapping the same file, and chip8_load
+// copies straight out of them, so any number of chip8 instances can be loaded from one open ROM.
+
+struct chip8_rom {
+    const char* data; // size bytes of the file, NULL for an empty file
+    size_t size;
+    void* handle; // File mapping object on Windows, unused elsewhere
+};
+
+// Returns 0 on success, -1 if the file could not be opened or mapped
+int chip8_rom_open(struct chip8_rom* rom, const char* filename);
+
+void chip8_rom_close(struct chip8_rom* rom);
+
+#endif
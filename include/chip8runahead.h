@@ -0,0 +1,26 @@
+#ifndef CHIP8RUNAHEAD_H
+#define CHIP8RUNAHEAD_H
+
+#include "chip8.h"
+
+// Run-ahead hides the input latency built into games. Many games read the keys (Ex9E/ExA1) a frame or more
+// before the result shows up on screen, so after emulating the real frame, the next frames are emulated
+// speculatively with the same keys held, their screen is kept for display, and the chip8 is rolled back.
+
+#define CHIP8_RUNAHEAD_MAX_FRAMES 8
+
+struct chip8_runahead {
+    int frames; // Number of frames to run ahead (0 disables run-ahead)
+    struct chip8* snapshot; // Room for XO-CHIP memory, NULL when run-ahead is disabled
+    struct chip8_screen screen; // Screen to display for the last frame
+};
+
+// Returns 0 on success, -1 if out of memory
+int chip8_runahead_init(struct chip8_runahead* runahead, int frames);
+
+void chip8_runahead_free(struct chip8_runahead* runahead);
+
+// Emulates one real frame, then runs ahead. The screen to display is left in runahead->screen.
+void chip8_runahead_frame(struct chip8_runahead* runahead, struct chip8* chip8);
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef CHIP8SAVESTATE_H
+#define CHIP8SAVESTATE_H
+
+#include <stddef.h>
+#include "config.h"
+
+struct chip8;
+
+// Save states serialize a whole chip8 into a versioned binary blob. All values are stored little endian and the
+// screen is bit-packed, so a blob written on one host can be loaded on any other.
+// ==> The keyboard map is a pointer to host configuration, it is not part of the state and is kept on load.
+//
+// Layout:
+//   "C8ST" magic, u16 version, V0 - VF, u16 I, u16 PC, u16 SP, u8 delay timer, u8 sound timer,
+//   u16 stack[CHIP8_TOTAL_STACK_DEPTH], u16 keys (Bit n = key n down), u32 rng, u64 cycles, u8 quirks,
+//   u8 high resolution, u8 selected planes, flags[CHIP8_TOTAL_RPL_FLAGS], audio pattern[CHIP8_AUDIO_PATTERN_SIZE],
+//   u8 pitch, memory[memory size], screen[CHIP8_SCREEN_PACKED_SIZE]
+// ==> Only the addressable memory is stored: CHIP8_XO_MEMORY_SIZE bytes if the quirks have CHIP8_QUIRK_XO_CHIP,
+//     CHIP8_MEMORY_SIZE otherwise, so save states of plain ROMs stay small
+
+#define CHIP8_SAVE_STATE_VERSION 1
+
+// Bytes before the quirks
+#define CHIP8_SAVE_STATE_HEADER_SIZE (4 + 2 + CHIP8_TOTAL_DATA_REGISTERS + 8 + CHIP8_TOTAL_STACK_DEPTH * 2 + 2 + 4 + 8)
+
+// Size of the largest save state (XO-CHIP), a buffer of this size holds any save state
+#define CHIP8_SAVE_STATE_SIZE (CHIP8_SAVE_STATE_HEADER_SIZE + 1 + 1 + 1 + CHIP8_TOTAL_RPL_FLAGS + \
+    CHIP8_AUDIO_PATTERN_SIZE + 1 + CHIP8_XO_MEMORY_SIZE + CHIP8_SCREEN_PACKED_SIZE)
+
+// Size of the save state of the given chip8
+size_t chip8_save_state_size(const struct chip8* chip8);
+
+// Returns the number of bytes written, or 0 if the buffer is smaller than chip8_save_state_size
+size_t chip8_save_state(const struct chip8* chip8, unsigned char* buf, size_t size);
+
+// Returns 0 on success, -1 if the blob is truncated, not a save state, of an unsupported version or saved with XO-CHIP
+// memory the chip8 has no room for (See chip8_new). The chip8 is left untouched on failure.
+int chip8_load_state(struct chip8* chip8, const unsigned char* buf, size_t size);
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef CHIP8SCHED_H
+#define CHIP8SCHED_H
+
+#include <stddef.h>
+#include "chip8job.h"
+
+// Runs many independent jobs on a pool of threads with work stealing:
+// ==> Every thread owns a deque of jobs. It takes work from the back of its own deque, and when that runs dry
+//     it steals from the front of another thread's deque.
+// ==> Jobs run in slices of CHIP8_SCHED_SLICE_FRAMES frames and go back to the deque of the thread that ran them,
+//     so a few very long jobs still get spread over idle threads instead of keeping one thread busy to the end.
+
+#define CHIP8_SCHED_SLICE_FRAMES 600 // 10 seconds of emulated time
+
+// Runs every job until it used up its budget. threads <= 0 uses one thread per core. Returns 0, or -1 if
+// the threads could not be started.
+int chip8_sched_run(struct chip8_job* jobs, size_t count, int threads);
+
+#endif
@@ -2,19 +2,73 @@
 #define CHIP8SCREEN_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "config.h"
 
+// The screen is stored with 1 bit per pixel, leftmost pixel in the highest bit: planes[p][y][0] holds pixels 0 - 63
+// of row y and planes[p][y][1] pixels 64 - 127. Drawing a sprite row is one shift and XOR per word and plane, and
+// SUPER-CHIP scrolls are row moves and 64-bit shifts.
+// ==> In low resolution (CHIP8_WIDTH x CHIP8_HEIGHT) only planes[p][0 .. CHIP8_HEIGHT - 1][0] are used
+// ==> In high resolution (CHIP8_HIRES_WIDTH x CHIP8_HIRES_HEIGHT, SUPER-CHIP 00FF) every word is used
+// ==> Plain CHIP-8 and SUPER-CHIP only ever select plane 0. XO-CHIP (Fn01) selects any combination of planes, a
+//     pixel's color being the planes it is set in.
 
 struct chip8_screen {
-    bool pixels[CHIP8_HEIGHT][CHIP8_WIDTH];
+    uint64_t planes[CHIP8_TOTAL_PLANES][CHIP8_HIRES_HEIGHT][2];
+    unsigned char plane_mask; // Planes drawn, cleared and scrolled (Bit n = plane n)
+    bool hires;
 };
 
+// Blanks the screen and selects plane 0, the state after chip8_init
+void chip8_screen_init(struct chip8_screen* screen);
+
+// Clears the selected planes
 void chip8_screen_clear(struct chip8_screen* screen);
 
+// Switches resolution, which clears every plane
+void chip8_screen_set_hires(struct chip8_screen* screen, bool hires);
+
+// Selects the planes the other functions work on (XO-CHIP Fn01), bit n selecting plane n
+void chip8_screen_select_planes(struct chip8_screen* screen, unsigned char plane_mask);
+
+int chip8_screen_width(const struct chip8_screen* screen);
+
+int chip8_screen_height(const struct chip8_screen* screen);
+
+// Sets a pixel in the selected planes
 void chip8_screen_set(struct chip8_screen* screen, int x, int y);
 
-bool chip8_screen_is_set(struct chip8_screen* screen, int x, int y);
+// Returns the planes a pixel is set in (Bit n = plane n), which is its color
+unsigned char chip8_screen_get(const struct chip8_screen* screen, int x, int y);
+
+// Returns true if the pixel is set in any plane
+bool chip8_screen_is_set(const struct chip8_screen* screen, int x, int y);
+
+// Returns true if both screens show the same picture (The selected planes are not compared)
+bool chip8_screen_equal(const struct chip8_screen* a, const struct chip8_screen* b);
 
+// Draws num rows of an 8 pixel wide sprite, or with num = 0 in high resolution a 16x16 sprite (2 bytes per row).
+// With several planes selected, the sprite of each plane follows the previous one in memory (Lowest plane first).
 bool chip8_screen_draw_sprite(struct chip8_screen* screen, int x, int y, const char* sprite, int num);
 
-#endif
\ No newline at end of file
+// Same as chip8_screen_draw_sprite, but only the starting position wraps: Pixels past the edges are not drawn
+bool chip8_screen_draw_sprite_clipped(struct chip8_screen* screen, int x, int y, const char* sprite, int num);
+
+// SUPER-CHIP scrolls: 00Cn scrolls down n rows, 00FB / 00FC scroll right / left 4 pixels. XO-CHIP adds 00Dn, scrolling
+// up n rows.
+void chip8_screen_scroll_down(struct chip8_screen* screen, int rows);
+
+void chip8_screen_scroll_up(struct chip8_screen* screen, int rows);
+
+void chip8_screen_scroll_right(struct chip8_screen* screen);
+
+void chip8_screen_scroll_left(struct chip8_screen* screen);
+
+// Packs the pixels into CHIP8_SCREEN_PACKED_SIZE bytes: For every plane, CHIP8_HIRES_HEIGHT rows of
+// CHIP8_HIRES_WIDTH / 8 bytes with the leftmost pixel in the highest bit. A low resolution picture is in the top left
+// corner, the rest is 0. The resolution and selected planes are not part of the packed pixels.
+void chip8_screen_pack(const struct chip8_screen* screen, unsigned char* out);
+
+void chip8_screen_unpack(struct chip8_screen* screen, const unsigned char* in);
+
+#endif
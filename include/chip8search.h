@@ -0,0 +1,49 @@
+#ifndef CHIP8SEARCH_H
+#define CHIP8SEARCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "chip8.h"
+
+// Breadth first search over input sequences. Starting from a snapshot of a chip8, every decision forks the state
+// into CHIP8_SEARCH_CHOICES copies (No key held, or one of the 16 keys held) and emulates each for a few frames.
+// ==> States are deduplicated by their hash (chip8_hash_state), so input sequences ending up in the same state
+//     are only explored once
+// ==> Children of a chunk of the frontier are emulated in parallel, deduplication and the goal check order are
+//     fixed, so the same sequence is found whatever the number of threads
+// Used for tool-assisted play (Reach a score, a level) and to find input sequences that crash a ROM.
+
+#define CHIP8_SEARCH_CHOICES (CHIP8_TOTAL_KEYS + 1)
+#define CHIP8_SEARCH_NO_KEY -1
+#define CHIP8_SEARCH_MAX_DEPTH 256
+
+// Returns true if the state is what the search is looking for
+typedef bool (*chip8_search_goal_fn)(const struct chip8* chip8, void* user);
+
+struct chip8_search {
+    // Configuration
+    int frames_per_decision; // Frames each choice is held for
+    int max_depth; // Decisions, at most CHIP8_SEARCH_MAX_DEPTH
+    size_t max_frontier; // States kept per depth, states past this are dropped (0 = no limit)
+    int threads; // <= 0 = One per core
+    chip8_search_goal_fn goal;
+    void* user;
+
+    // Result
+    bool found;
+    int depth; // Number of decisions in path
+    signed char path[CHIP8_SEARCH_MAX_DEPTH]; // Key held for each decision, or CHIP8_SEARCH_NO_KEY
+    struct chip8* state; // State the path leads to, allocated by chip8_search_run
+    size_t explored; // States emulated
+    size_t duplicates; // States dropped because they had been seen before
+};
+
+// Sets every configuration value to its default
+void chip8_search_init(struct chip8_search* search, chip8_search_goal_fn goal, void* user);
+
+// Returns 0 when the search finished (See search->found), -1 if out of memory
+int chip8_search_run(struct chip8_search* search, const struct chip8* root);
+
+void chip8_search_free(struct chip8_search* search);
+
+#endif
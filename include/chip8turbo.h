@@ -0,0 +1,31 @@
+#ifndef CHIP8TURBO_H
+#define CHIP8TURBO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Fast-forward runs the emulation uncapped while the display keeps its pace: Every displayed frame emulates N frames
+// and only the last one is drawn. N adapts to the measured cost of a frame, so that emulating fits in
+// CHIP8_TURBO_BUDGET_PERCENT of a displayed frame whatever the ROM and host.
+// ==> The caller times the frames it emulates (e.g. with chip8_platform_now) and reports it with chip8_turbo_update
+// ==> Timers still tick once per emulated frame, so the game runs N times faster and not just its instructions
+
+struct chip8_turbo {
+    bool enabled;
+    int frames; // Frames to emulate per displayed frame (N) while enabled
+    uint64_t budget; // Nanoseconds of emulation per displayed frame
+    uint64_t frame_cost; // Smoothed nanoseconds per emulated frame, 0 until the first measurement
+};
+
+// Starts disabled. frame_time is the time of one displayed frame in nanoseconds.
+void chip8_turbo_init(struct chip8_turbo* turbo, uint64_t frame_time);
+
+void chip8_turbo_set(struct chip8_turbo* turbo, bool enabled);
+
+// Returns the number of frames to emulate for the next displayed frame, 1 while disabled
+int chip8_turbo_frames(const struct chip8_turbo* turbo);
+
+// Reports that emulating frames frames took elapsed nanoseconds, and adapts N to it
+void chip8_turbo_update(struct chip8_turbo* turbo, int frames, uint64_t elapsed);
+
+#endif
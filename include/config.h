@@ -4,16 +4,40 @@
 #define EMULATOR_WINDOW_TITLE "Chip8 Emulator"
 
 #define CHIP8_MEMORY_SIZE 4096  // Memory size of CHIP8 (4 KB = 4096 bytes)
+#define CHIP8_XO_MEMORY_SIZE 65536 // XO-CHIP memory size (64 KB), addressed through F000 nnnn
 #define CHIP8_PROGRAM_LOAD_ADDRESS 0x200 // Memory location where most CHIP8 programs start
 
 #define CHIP8_WIDTH 64
 #define CHIP8_HEIGHT 32
 #define CHIP8_WINDOW_MULTIPLIER 10
+#define CHIP8_HIRES_WIDTH 128 // SUPER-CHIP high resolution mode
+#define CHIP8_HIRES_HEIGHT 64
+#define CHIP8_TOTAL_PLANES 2 // XO-CHIP bit-planes, plain CHIP-8 and SUPER-CHIP only draw to the first one
+#define CHIP8_SCREEN_PACKED_SIZE (CHIP8_TOTAL_PLANES * CHIP8_HIRES_WIDTH * CHIP8_HIRES_HEIGHT / 8) // Bytes needed to store the screen with 1 bit per pixel and plane
 
 #define CHIP8_TOTAL_DATA_REGISTERS 16
 #define CHIP8_TOTAL_STACK_DEPTH 16
 #define CHIP8_TOTAL_KEYS 16
 #define CHIP8_CHARACTER_SET_LOAD_ADDRESS 0x00
 #define CHIP8_DEFAULT_SPRITE_HEIGHT 5
+#define CHIP8_BIG_CHARACTER_SET_LOAD_ADDRESS 0x50 // SUPER-CHIP 8x10 digits, right after the default ones
+#define CHIP8_BIG_SPRITE_HEIGHT 10
+#define CHIP8_TOTAL_RPL_FLAGS 16 // SUPER-CHIP user flags (Fx75 / Fx85), 8 on the HP48 and 16 on XO-CHIP
+#define CHIP8_AUDIO_PATTERN_SIZE 16 // XO-CHIP audio pattern (F002), 128 one bit samples
+#define CHIP8_DEFAULT_PITCH 64 // XO-CHIP pitch (Fx3A), 64 plays the pattern at 4000 samples per second
+#define CHIP8_AUDIO_PATTERN_RATE 4000 // Pattern samples per second at the default pitch, doubling every 48 pitch steps
+#define CHIP8_AUDIO_SAMPLE_RATE 44100 // Host audio output
+#define CHIP8_AUDIO_VOLUME 3000 // Amplitude of the square wave, out of 32767
+#define CHIP8_BEEP_FREQUENCY 1500 // Tone played while the sound timer runs, for ROMs without an audio pattern
+
+#define CHIP8_CYCLES_PER_FRAME 10 // Instructions executed per 60Hz frame (~600 instructions per second)
+#define CHIP8_FRAMES_PER_SECOND 60
+#define CHIP8_DEFAULT_RNG_SEED 0x2545F491 // Seed used for Cxkk until the host reseeds the VM
+
+#define CHIP8_REWIND_BUDGET (4 * 1024 * 1024) // Memory used for rewinding, enough for several minutes of gameplay
+#define CHIP8_REWIND_KEYFRAME_INTERVAL 60 // One full snapshot per second, every other frame is stored as a delta
+
+#define CHIP8_TURBO_BUDGET_PERCENT 75 // Share of a displayed frame spent emulating while fast-forwarding, the rest is for drawing
+#define CHIP8_TURBO_MAX_FRAMES 1000 // Most frames emulated per displayed frame while fast-forwarding
 
 #endif
\ No newline at end of file
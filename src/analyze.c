@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "chip8.h"
+#include "chip8analysis.h"
+#include "chip8rom.h"
+
+// Static analyzer: Prints the control flow graph of a ROM, block by block with its disassembly, followed by the
+// ranges of memory used as data and anything that keeps the analysis from being complete.
+// Usage: analyze <rom> [--quirks profile]
+
+static void usage(void) {
+    printf("Usage: analyze <rom> [--quirks profile]\n");
+}
+
+static const char* yes_no(bool value) {
+    return value ? "yes" : "no";
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return -1;
+    }
+
+    const char* filename = argv[1];
+    const struct chip8_quirk_profile* profile = chip8_quirk_profile_find("default");
+
+    for (int i = 2; i < argc; i++) {
+        if (i + 1 >= argc) {
+            usage();
+            return -1;
+        }
+
+        if (strcmp(argv[i], "--quirks") == 0) {
+            profile = chip8_quirk_profile_find(argv[++i]);
+            if (!profile) {
+                printf("Unknown quirk profile %s\n", argv[i]);
+                return -1;
+            }
+        } else {
+            usage();
+            return -1;
+        }
+    }
+
+    struct chip8_rom rom;
+    if (chip8_rom_open(&rom, filename) != 0) {
+        printf("Failed to open file\n");
+        return -1;
+    }
+
+    struct chip8* chip8 = chip8_new(profile->quirks & CHIP8_QUIRK_XO_CHIP ? CHIP8_XO_MEMORY_SIZE : CHIP8_MEMORY_SIZE);
+    if (!chip8) {
+        printf("Out of memory\n");
+        return -1;
+    }
+    chip8_set_quirks(chip8, profile->quirks);
+    if (chip8_load(chip8, rom.data, rom.size) != 0) {
+        printf("%s does not fit in memory (%zu bytes)\n", filename, rom.size);
+        return -1;
+    }
+    size_t size = rom.size;
+    chip8_rom_close(&rom);
+
+    static struct chip8_analysis analysis;
+    chip8_analyze(chip8, &analysis);
+
+    int data_bytes = 0;
+    int unreached_bytes = 0;
+    for (size_t i = CHIP8_PROGRAM_LOAD_ADDRESS; i < CHIP8_PROGRAM_LOAD_ADDRESS + size; i++) {
+        data_bytes += (analysis.flags[i] & CHIP8_ANALYSIS_DATA) != 0;
+        unreached_bytes += (analysis.flags[i] & (CHIP8_ANALYSIS_CODE | CHIP8_ANALYSIS_OPERAND | CHIP8_ANALYSIS_DATA)) == 0;
+    }
+
+    printf("%s: %zu instructions in %zu blocks, %d bytes of data, %d bytes neither\n", filename, analysis.instruction_count,
+        analysis.block_count, data_bytes, unreached_bytes);
+    printf("self-modifying: %s, writes through unknown I: %s, computed jumps: %s, invalid opcodes: %zu\n",
+        yes_no(analysis.self_modifying), yes_no(analysis.unknown_writes), yes_no(analysis.computed_jumps), analysis.invalid_count);
+
+    for (size_t b = 0; b < analysis.block_count; b++) {
+        const struct chip8_block* block = &analysis.blocks[b];
+        printf("\nblock %03x%s ->", block->start, analysis.flags[block->start] & CHIP8_ANALYSIS_CALL_TARGET ? " (subroutine)" : "");
+        for (int s = 0; s < block->successor_count; s++) {
+            printf(" %03x", block->successors[s]);
+        }
+        printf("%s%s\n", block->returns ? " return" : "", block->computed ? " computed" : "");
+
+        for (unsigned short pc = block->start; pc < block->end; pc += 2) {
+            unsigned short opcode = chip8->memory.memory[pc] << 8 | chip8->memory.memory[pc + 1];
+            char text[32];
+            chip8_disassemble(opcode, text, sizeof(text));
+            printf("  %03x: %04x  %s%s\n", pc, opcode, text, analysis.flags[pc] & CHIP8_ANALYSIS_WRITTEN ? "  ; written" : "");
+
+            // The address of an XO-CHIP F000 nnnn
+            if (pc + 2u < analysis.memory_size && !(analysis.flags[pc + 2] & CHIP8_ANALYSIS_CODE) && (analysis.flags[pc + 2] & CHIP8_ANALYSIS_OPERAND)) {
+                pc += 2;
+                printf("  %03x: %04x\n", pc, chip8->memory.memory[pc] << 8 | chip8->memory.memory[pc + 1]);
+            }
+        }
+    }
+
+    printf("\ndata:");
+    for (int i = 0; i < (int) analysis.memory_size; i++) {
+        if (!(analysis.flags[i] & CHIP8_ANALYSIS_DATA) || (i > 0 && (analysis.flags[i - 1] & CHIP8_ANALYSIS_DATA))) {
+            continue;
+        }
+        int end = i;
+        while (end + 1 < (int) analysis.memory_size && (analysis.flags[end + 1] & CHIP8_ANALYSIS_DATA)) {
+            end++;
+        }
+        printf(" %03x-%03x", i, end);
+    }
+    printf("\n");
+
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "chip8batch.h"
+#include "chip8job.h"
+
+// Runs every job of a job file (See chip8job.h) in isolated worker processes, then prints one line per job:
+// <rom> <status> <frames> <instructions> <final state hash>
+// Usage: batch <jobfile> [--workers n]
+
+static const char* chip8_batch_status_names[] = { "pending", "running", "done", "crashed" };
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printf("Usage: batch <jobfile> [--workers n]\n");
+        return -1;
+    }
+
+    int workers = 0;
+    if (argc >= 4 && strcmp(argv[2], "--workers") == 0) {
+        workers = atoi(argv[3]);
+    }
+
+    struct chip8_job* jobs;
+    size_t count;
+    if (chip8_jobs_load(argv[1], &jobs, &count) != 0) {
+        printf("Failed to load jobs from %s\n", argv[1]);
+        return -1;
+    }
+
+    struct chip8_batch_result* results;
+    if (chip8_batch_run(jobs, count, workers, &results) != 0) {
+        printf("Failed to run worker processes\n");
+        return -1;
+    }
+
+    int crashed = 0;
+    for (size_t i = 0; i < count; i++) {
+        printf("%s %s %lu %lu %016llx\n", jobs[i].rom, chip8_batch_status_names[results[i].status], results[i].frames,
+            results[i].cycles, (unsigned long long) results[i].hash);
+        crashed += results[i].status == CHIP8_BATCH_CRASHED;
+    }
+    fprintf(stderr, "%zu jobs, %d crashed\n", count, crashed);
+
+    chip8_batch_free(results, count);
+    chip8_jobs_free(jobs, count);
+    return crashed ? 1 : 0;
+}
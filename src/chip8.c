@@ -1,14 +1,14 @@
 #include "chip8.h"
 #include "chip8screen.h"
-#include "SDL2/SDL.h"
 #include "chip8keyboard.h"
+#include "chip8idle.h"
+#include "chip8fuse.h"
 
 #include<memory.h>
-#include <assert.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 #include <stdlib.h>
-#include <time.h>
 
 // Chip8 draws graphics on the screen through the use of SPRITES - Group of bytes which are binary is representation
 // of the desired picture. Chip-8 sprites are up to 15 bytes (8x15 pixels)
@@ -36,22 +36,79 @@ const char chip8_default_character_set[] = {
 
 };
 
+// SUPER-CHIP 8x10 digits used by Fx30 (Loaded at CHIP8_BIG_CHARACTER_SET_LOAD_ADDRESS, 10 bytes each)
+const char chip8_big_character_set[] = {
+    0xff, 0xff, 0xc3, 0xc3, 0xc3, 0xc3, 0xc3, 0xc3, 0xff, 0xff,   // 0
+    0x18, 0x78, 0x78, 0x18, 0x18, 0x18, 0x18, 0x18, 0xff, 0xff,   // 1
+    0xff, 0xff, 0x03, 0x03, 0xff, 0xff, 0xc0, 0xc0, 0xff, 0xff,   // 2
+    0xff, 0xff, 0x03, 0x03, 0xff, 0xff, 0x03, 0x03, 0xff, 0xff,   // 3
+    0xc3, 0xc3, 0xc3, 0xc3, 0xff, 0xff, 0x03, 0x03, 0x03, 0x03,   // 4
+    0xff, 0xff, 0xc0, 0xc0, 0xff, 0xff, 0x03, 0x03, 0xff, 0xff,   // 5
+    0xff, 0xff, 0xc0, 0xc0, 0xff, 0xff, 0xc3, 0xc3, 0xff, 0xff,   // 6
+    0xff, 0xff, 0x03, 0x03, 0x06, 0x0c, 0x18, 0x18, 0x18, 0x18,   // 7
+    0xff, 0xff, 0xc3, 0xc3, 0xff, 0xff, 0xc3, 0xc3, 0xff, 0xff,   // 8
+    0xff, 0xff, 0xc3, 0xc3, 0xff, 0xff, 0x03, 0x03, 0xff, 0xff,   // 9
+    0x7e, 0xff, 0xc3, 0xc3, 0xc3, 0xff, 0xff, 0xc3, 0xc3, 0xc3,   // A
+    0xfc, 0xfc, 0xc3, 0xc3, 0xfc, 0xfc, 0xc3, 0xc3, 0xfc, 0xfc,   // B
+    0x3c, 0xff, 0xc3, 0xc0, 0xc0, 0xc0, 0xc0, 0xc3, 0xff, 0x3c,   // C
+    0xfc, 0xfe, 0xc3, 0xc3, 0xc3, 0xc3, 0xc3, 0xc3, 0xfe, 0xfc,   // D
+    0xff, 0xff, 0xc0, 0xc0, 0xff, 0xff, 0xc0, 0xc0, 0xff, 0xff,   // E
+    0xff, 0xff, 0xc0, 0xc0, 0xff, 0xff, 0xc0, 0xc0, 0xc0, 0xc0    // F
+};
+
+struct chip8* chip8_new(size_t memory_size) {
+    struct chip8* chip8 = malloc(CHIP8_SIZE(memory_size));
+    if (!chip8) {
+        return NULL;
+    }
+
+    chip8->memory.capacity = memory_size;
+    chip8_init(chip8);
+    return chip8;
+}
+
 void chip8_init(struct chip8* chip8) {
-    // Setting all values to null
-    memset(chip8, 0, sizeof(struct chip8));
+    // Setting all values to null, memory included
+    unsigned int capacity = chip8->memory.capacity;
+    memset(chip8, 0, CHIP8_SIZE(capacity));
+    chip8->memory.capacity = capacity;
+    chip8_set_quirks(chip8, 0);
+    chip8_screen_init(&chip8->screen);
+    chip8->pitch = CHIP8_DEFAULT_PITCH;
     
     // Initialize chip8 memory - Loading character set into chip8 memory
+    // ==> The big font is only loaded along with CHIP8_QUIRK_SCHIP (See chip8_set_quirks), plain ROMs read zeros there
     memcpy(&chip8->memory.memory, chip8_default_character_set, sizeof(chip8_default_character_set));
+
+    chip8_seed(chip8, CHIP8_DEFAULT_RNG_SEED);
+}
+
+void chip8_seed(struct chip8* chip8, unsigned int seed) {
+    // Xorshift gets stuck at 0 forever, so a zero seed falls back to the default one
+    chip8->rng = seed ? seed : CHIP8_DEFAULT_RNG_SEED;
 }
 
-void chip8_load(struct chip8* chip8, const char* buffer, size_t size) {
-    // If the size of the given program is over the CHIP8 memory size, then it throws an error
+// Xorshift32 - Cheap, and its whole state lives inside struct chip8 so snapshots of a VM also capture its randomness
+static unsigned char chip8_random(struct chip8* chip8) {
+    unsigned int r = chip8->rng;
+    r ^= r << 13;
+    r ^= r >> 17;
+    r ^= r << 5;
+    chip8->rng = r;
+    return r >> 24;
+}
+
+int chip8_load(struct chip8* chip8, const char* buffer, size_t size) {
+    // If the size of the given program is over the CHIP8 memory size, then nothing is loaded
     // (NOTE: We add size with CHIP8_PROGRAM_LOAD_ADDRESS because mist chip-8 programs start at memory location 0x200)
-    assert(size+CHIP8_PROGRAM_LOAD_ADDRESS < CHIP8_MEMORY_SIZE);
+    if (size + CHIP8_PROGRAM_LOAD_ADDRESS > chip8_memory_size(&chip8->memory)) {
+        return -1;
+    }
 
     memcpy(&chip8->memory.memory[CHIP8_PROGRAM_LOAD_ADDRESS], buffer, size);     // Loading the buffer source to chip8 mmeory
 
     chip8->registers.PC = CHIP8_PROGRAM_LOAD_ADDRESS;   // Setting the program counter to the starting load address
+    return 0;
 }
 
 
@@ -63,8 +120,21 @@ void chip8_load(struct chip8* chip8, const char* buffer, size_t size) {
 * kk or byte - An 8-bit value, the lowest 8 bits of the instruction
 *******************************************************************/
 
+// Quirk profiles: The interpreter below is written once, taking the quirks as a constant, and instantiated for every
+// combination of quirks (See CHIP8_INTERPRETER at the bottom). Each instance is compiled with its quirks folded in,
+// so the hot path carries no quirk checks; chip8_run picks the instance matching chip8->quirks once per call, and
+// chip8_run_frame calls the frame runner chip8_set_quirks picked.
+
+// Skips the next instruction. XO-CHIP's F000 nnnn is 4 bytes long, so it is skipped as a whole.
+CHIP8_SPECIALIZED void chip8_skip(struct chip8* chip8, const unsigned int quirks) {
+    if ((quirks & CHIP8_QUIRK_XO_CHIP) && chip8_memory_get_short(chip8, chip8->registers.PC) == 0xF000) {
+        chip8->registers.PC += 2;
+    }
+    chip8->registers.PC += 2; // Each instruction in CHIP8 is 2 bytes, therefore skip by 2
+}
+
 // 8xy0, 8xy1, 8xy2, 8xy3, ..., 8xy7, 8xyE
-static void chip8_exec_extended_eight(struct chip8* chip8, unsigned short opcode) {
+CHIP8_SPECIALIZED void chip8_exec_extended_eight(struct chip8* chip8, unsigned short opcode, const unsigned int quirks) {
     unsigned char x = (opcode >> 8) & 0x000f;
     unsigned char y = (opcode >> 4) & 0x000f;
     unsigned char final_four_bits = opcode & 0x000f;
@@ -106,7 +176,14 @@ static void chip8_exec_extended_eight(struct chip8* chip8, unsigned short opcode
         break;
 
         // 8xy6 - SHR Vx {, Vy} - If the least-significant bit of Vx is 1, then VF is set to 1, otherwise 0. Then Vx is divided by 2.
+        // ==> CHIP8_QUIRK_SHIFT_VY: Vy is shifted and the result stored in Vx
         case 0x06:
+            if (quirks & CHIP8_QUIRK_SHIFT_VY) {
+                tmp = chip8->registers.V[y];
+                chip8->registers.V[0x0f] = tmp & 0x01;
+                chip8->registers.V[x] = tmp / 2;
+                break;
+            }
             chip8->registers.V[0x0f] = chip8->registers.V[x] & 0x01; 
             chip8->registers.V[x] /= 2;
         break;
@@ -118,43 +195,74 @@ static void chip8_exec_extended_eight(struct chip8* chip8, unsigned short opcode
         break;
 
         // 8xyE - SHL Vx {, Vy} - If the most-significant bit of Vx is 1, then VF is set to 1, otherwise to 0. Then Vx is multiplied by 2.
+        // ==> CHIP8_QUIRK_SHIFT_VY: Vy is shifted and the result stored in Vx
         case 0x0E:
+            if (quirks & CHIP8_QUIRK_SHIFT_VY) {
+                tmp = chip8->registers.V[y];
+                chip8->registers.V[0x0f] = tmp & 0x80;
+                chip8->registers.V[x] = tmp * 2;
+                break;
+            }
             chip8->registers.V[0x0f] = chip8->registers.V[x] & 0x80;
             chip8->registers.V[x] *= 2;
         break;
     }
 }
 
+// Returns the first CHIP8 key that is currently held down, or -1 if none are
 static char chip8_wait_for_key_press(struct chip8* chip8) {
-    SDL_Event event;
-
-    while(SDL_WaitEvent(&event)) {
-        if (event.type != SDL_KEYDOWN)
-            continue;
-        
-        char c = event.key.keysym.sym;  // Raw key data being pressed
-        char chip8_key = chip8_keyboard_map(&chip8->keyboard, c);
-        if (chip8_key != -1) {
-            return chip8_key;
+    for (int i = 0; i < CHIP8_TOTAL_KEYS; i++) {
+        if (chip8_keyboard_is_down(&chip8->keyboard, i)) {
+            return i;
         }
     }
 
     return -1;
 }
 
-static void chip8_exec_extended_F(struct chip8* chip8, unsigned short opcode) {
+CHIP8_SPECIALIZED void chip8_exec_extended_F(struct chip8* chip8, unsigned short opcode, const unsigned int quirks) {
     unsigned char x = (opcode >> 8) & 0x000f;
 
     switch (opcode & 0x00FF) {
+        // F000 nnnn - LD I, long addr - Set I = the 16-bit address in the next 2 bytes (XO-CHIP).
+        case 0x00:
+            if ((quirks & CHIP8_QUIRK_XO_CHIP) && x == 0) {
+                chip8->registers.I = chip8_memory_get_short(chip8, chip8->registers.PC);
+                chip8->registers.PC += 2;
+            }
+        break;
+
+        // Fn01 - PLANE n - Select the planes drawn, cleared and scrolled (XO-CHIP).
+        case 0x01:
+            if (quirks & CHIP8_QUIRK_XO_CHIP) {
+                chip8_screen_select_planes(&chip8->screen, x);
+            }
+        break;
+
+        // F002 - AUDIO - Load the 16 byte audio pattern from memory at location I (XO-CHIP).
+        case 0x02:
+            if ((quirks & CHIP8_QUIRK_XO_CHIP) && x == 0) {
+                for (int i = 0; i < CHIP8_AUDIO_PATTERN_SIZE; i++) {
+                    chip8->audio_pattern[i] = chip8_memory_get(chip8, chip8->registers.I + i);
+                }
+            }
+        break;
+
         // Fx07 - LD Vx, DT - Set Vx to the delay timer value
         case 0x07:
             chip8->registers.V[x] = chip8->registers.delay_timer;
         break;
 
         // Fx0A - LD Vx, K - Wait for a key press, store the value of the key in Vx.
+        // ==> Instead of blocking inside the interpreter, the instruction is executed again until a key is down.
+        //     This keeps the core free of any host event handling, so it can also run headless.
         case 0x0A:
         {
             char pressed_key = chip8_wait_for_key_press(chip8);
+            if (pressed_key == -1) {
+                chip8->registers.PC -= 2;
+                break;
+            }
             chip8->registers.V[x] = pressed_key;
         } 
         break;
@@ -179,6 +287,20 @@ static void chip8_exec_extended_F(struct chip8* chip8, unsigned short opcode) {
             chip8->registers.I = chip8->registers.V[x] * CHIP8_DEFAULT_SPRITE_HEIGHT;
         break;
 
+        // Fx30 - LD HF, Vx - Set I = location of the big (SUPER-CHIP) sprite for digit Vx.
+        case 0x30:
+            if (quirks & CHIP8_QUIRK_SCHIP) {
+                chip8->registers.I = CHIP8_BIG_CHARACTER_SET_LOAD_ADDRESS + (chip8->registers.V[x] & 0x0f) * CHIP8_BIG_SPRITE_HEIGHT;
+            }
+        break;
+
+        // Fx3A - PITCH Vx - Set the audio pattern playback rate to 4000 * 2 ^ ((Vx - 64) / 48) Hz (XO-CHIP).
+        case 0x3A:
+            if (quirks & CHIP8_QUIRK_XO_CHIP) {
+                chip8->pitch = chip8->registers.V[x];
+            }
+        break;
+
         // Fx33 - LD B, Vx - The interpreter takes the decimal value of Vx, and places the hundreds 
         // digit in memory at location in I, the tens digit at location I+1, and the ones digit at location I+2.
         case 0x33:
@@ -186,32 +308,54 @@ static void chip8_exec_extended_F(struct chip8* chip8, unsigned short opcode) {
             unsigned char hundreds = chip8->registers.V[x] / 100;
             unsigned char tens = chip8->registers.V[x] / 10 % 10;
             unsigned char units = chip8->registers.V[x] % 10;
-            chip8_memory_set(&chip8->memory, chip8->registers.I, hundreds);
-            chip8_memory_set(&chip8->memory, chip8->registers.I + 1, tens);
-            chip8_memory_set(&chip8->memory, chip8->registers.I + 2, units);
+            chip8_memory_set(chip8, chip8->registers.I, hundreds);
+            chip8_memory_set(chip8, chip8->registers.I + 1, tens);
+            chip8_memory_set(chip8, chip8->registers.I + 2, units);
         }
 
         // Fx55 - LD [I], Vx - The interpreter copies the values of registers V0 through Vx into memory, starting at the address in I.
+        // ==> CHIP8_QUIRK_LOAD_STORE_I: I is left pointing past the last register stored
         case 0x55:
         {
             for (int i = 0; i <= x; i++) {
-                chip8_memory_set(&chip8->memory, chip8->registers.I + i, chip8->registers.V[i]);
+                chip8_memory_set(chip8, chip8->registers.I + i, chip8->registers.V[i]);
+            }
+            if (quirks & CHIP8_QUIRK_LOAD_STORE_I) {
+                chip8->registers.I += x + 1;
             }
         }
         break;
 
         // Fx65 - LD Vx, [I] - The interpreter reads values from memory starting at location I into registers V0 through Vx.
+        // ==> CHIP8_QUIRK_LOAD_STORE_I: I is left pointing past the last register loaded
         case 0x65:
         {
             for (int i = 0; i <= x; i++) {
-                chip8->registers.V[i] = chip8_memory_get(&chip8->memory, chip8->registers.I + i);
+                chip8->registers.V[i] = chip8_memory_get(chip8, chip8->registers.I + i);
+            }
+            if (quirks & CHIP8_QUIRK_LOAD_STORE_I) {
+                chip8->registers.I += x + 1;
             }
         }
         break;
+
+        // Fx75 - LD R, Vx - Store V0 through Vx in the user flags (SUPER-CHIP, RPL flags on the HP48).
+        case 0x75:
+            if (quirks & CHIP8_QUIRK_SCHIP) {
+                memcpy(chip8->flags, chip8->registers.V, x + 1);
+            }
+        break;
+
+        // Fx85 - LD Vx, R - Read V0 through Vx from the user flags (SUPER-CHIP).
+        case 0x85:
+            if (quirks & CHIP8_QUIRK_SCHIP) {
+                memcpy(chip8->registers.V, chip8->flags, x + 1);
+            }
+        break;
     }
 }
 
-static void chip8_exec_extended(struct chip8* chip8, unsigned short opcode) {
+CHIP8_SPECIALIZED void chip8_exec_extended(struct chip8* chip8, unsigned short opcode, const unsigned int quirks) {
     // Ex: 2nnn
     unsigned short nnn = opcode & 0x0fff;
 
@@ -225,6 +369,16 @@ static void chip8_exec_extended(struct chip8* chip8, unsigned short opcode) {
     unsigned char n = opcode & 0x000f;
 
     switch(opcode & 0xf000) {
+        // 00Cn - SCD nibble - Scroll the display down n rows (SUPER-CHIP).
+        // 00Dn - SCU nibble - Scroll the display up n rows (XO-CHIP). Any other 0nnn (SYS addr) is ignored.
+        case 0x0000:
+            if ((quirks & CHIP8_QUIRK_SCHIP) && (opcode & 0xfff0) == 0x00C0) {
+                chip8_screen_scroll_down(&chip8->screen, n);
+            } else if ((quirks & CHIP8_QUIRK_XO_CHIP) && (opcode & 0xfff0) == 0x00D0) {
+                chip8_screen_scroll_up(&chip8->screen, n);
+            }
+        break;
+
         // JP addr - 1nnn jump to location nnn's
         case 0x1000:
             chip8->registers.PC = nnn;
@@ -239,21 +393,35 @@ static void chip8_exec_extended(struct chip8* chip8, unsigned short opcode) {
         // SE Vx, byte - 3xkk Skip next instruction if Vx=kk
         case 0x3000:
             if (chip8->registers.V[x] == kk) {
-                chip8->registers.PC += 2; // Each instruction in CHIP8 is 2 bytes, therefore skip by 2
+                chip8_skip(chip8, quirks);
             }
         break;
 
         // SNE Vx, byte - Skip next instruction if Vx != kk.
         case 0x4000:
             if (chip8->registers.V[x] != kk) {
-                chip8->registers.PC += 2; // Each instruction in CHIP8 is 2 bytes, therefore skip by 2
+                chip8_skip(chip8, quirks);
             }
         break;
 
         // SE Vx, Vy - Skip the next instruction if V[x] == V[y]
+        // 5xy2 - SAVE Vx - Vy - Store Vx through Vy in memory starting at location I, I is unchanged (XO-CHIP).
+        // 5xy3 - LOAD Vx - Vy - Read Vx through Vy from memory starting at location I, I is unchanged (XO-CHIP).
+        // ==> With x > y the registers are stored / read in descending order
         case 0x5000:
+            if ((quirks & CHIP8_QUIRK_XO_CHIP) && (n == 0x02 || n == 0x03)) {
+                int step = x <= y ? 1 : -1;
+                for (int i = 0; i <= abs(y - x); i++) {
+                    if (n == 0x02) {
+                        chip8_memory_set(chip8, chip8->registers.I + i, chip8->registers.V[x + i * step]);
+                    } else {
+                        chip8->registers.V[x + i * step] = chip8_memory_get(chip8, chip8->registers.I + i);
+                    }
+                }
+                break;
+            }
             if (chip8->registers.V[x] == chip8->registers.V[y]) {
-                chip8->registers.PC += 2;
+                chip8_skip(chip8, quirks);
             }
         break;
 
@@ -268,13 +436,13 @@ static void chip8_exec_extended(struct chip8* chip8, unsigned short opcode) {
         break;
 
         case 0x8000:
-            chip8_exec_extended_eight(chip8, opcode);
+            chip8_exec_extended_eight(chip8, opcode, quirks);
         break;
 
         // 9xy0 - SNE Vx, Vy - Skip next instruction if Vx != Vy.
         case 0x9000:
             if (chip8->registers.V[x] != chip8->registers.V[y]) {
-                chip8->registers.PC += 2;
+                chip8_skip(chip8, quirks);
             }
         break;
 
@@ -284,21 +452,38 @@ static void chip8_exec_extended(struct chip8* chip8, unsigned short opcode) {
         break;
 
         // Bnn - JP V0, addr - Jump to location nnn + V0
+        // ==> CHIP8_QUIRK_JUMP_VX: Bxnn jumps to xnn + Vx
         case 0xB000:
-            chip8->registers.PC = nnn + chip8->registers.V[0x00];
+            chip8->registers.PC = nnn + chip8->registers.V[quirks & CHIP8_QUIRK_JUMP_VX ? x : 0x00];
         break;
 
         // Cxkk - RND Vx, byte - Set Vx = random byte AND kk.
         case 0xC000:
-            srand(clock());
-            chip8->registers.V[x] = (rand() % 255) & kk;
+            chip8->registers.V[x] = chip8_random(chip8) & kk;
         break;
 
         // Dxyn - DRW Vx, Vy, nibble - Display n-byte sprite starting at memory location I at (Vx, Vy), set VF = collision.
+        // ==> CHIP8_QUIRK_CLIP_SPRITES: Parts of the sprite past the edges of the screen are not drawn
+        // ==> Dxy0 in high resolution draws a 16x16 sprite (SUPER-CHIP)
+        // ==> Each selected plane reads its own sprite, following the previous plane's one (XO-CHIP)
         case 0xD000:
         {
             const char* sprite = (const char*) &chip8->memory.memory[chip8->registers.I];
-            chip8->registers.V[0x0f] = chip8_screen_draw_sprite(&chip8->screen, chip8->registers.V[x], chip8->registers.V[y], sprite, n);
+
+            // A sprite at the very end of memory (Or past it, see CHIP8_TRAP_MEMORY) wraps around to the start
+            char wrapped[CHIP8_TOTAL_PLANES * 32];
+            if (chip8->registers.I > chip8->memory.mask + 1 - sizeof(wrapped)) {
+                chip8->trap |= chip8->registers.I > chip8->memory.mask ? CHIP8_TRAP_MEMORY : 0;
+                for (size_t i = 0; i < sizeof(wrapped); i++) {
+                    wrapped[i] = chip8->memory.memory[(chip8->registers.I + i) & chip8->memory.mask];
+                }
+                sprite = wrapped;
+            }
+            if (quirks & CHIP8_QUIRK_CLIP_SPRITES) {
+                chip8->registers.V[0x0f] = chip8_screen_draw_sprite_clipped(&chip8->screen, chip8->registers.V[x], chip8->registers.V[y], sprite, n);
+            } else {
+                chip8->registers.V[0x0f] = chip8_screen_draw_sprite(&chip8->screen, chip8->registers.V[x], chip8->registers.V[y], sprite, n);
+            }
         }
         break;
 
@@ -307,13 +492,13 @@ static void chip8_exec_extended(struct chip8* chip8, unsigned short opcode) {
             switch(opcode & 0x00ff) {
                 case 0x9E: // Ex9E - SKP Vx - Skip next instruction if key with the value of Vx is pressed.
                     if (chip8_keyboard_is_down(&chip8->keyboard, chip8->registers.V[x])) {
-                        chip8->registers.PC += 2;
+                        chip8_skip(chip8, quirks);
                     }
                 break;
 
                 case 0xA1: // ExA1 - SKNP Vx - Skip next instruction if key with the value of Vx is not pressed.
                     if (!chip8_keyboard_is_down(&chip8->keyboard, chip8->registers.V[x])) {
-                        chip8->registers.PC += 2;
+                        chip8_skip(chip8, quirks);
                     }
                 break;
             }
@@ -322,14 +507,42 @@ static void chip8_exec_extended(struct chip8* chip8, unsigned short opcode) {
 
         // Fx07 - LD Vx, DT - Set Vx = delay timer value.
         case 0xF000:
-            chip8_exec_extended_F(chip8, opcode);
+            chip8_exec_extended_F(chip8, opcode, quirks);
+        break;
+    }
+}
+
+// SUPER-CHIP instructions without operands, anything else goes on to chip8_exec_extended (CHIP8_QUIRK_SCHIP only)
+CHIP8_SPECIALIZED void chip8_exec_schip(struct chip8* chip8, unsigned short opcode, const unsigned int quirks) {
+    switch(opcode) {
+        case 0x00FB: // Scroll the display right 4 pixels.
+            chip8_screen_scroll_right(&chip8->screen);
         break;
+
+        case 0x00FC: // Scroll the display left 4 pixels.
+            chip8_screen_scroll_left(&chip8->screen);
+        break;
+
+        case 0x00FD: // Exit the interpreter. There is nothing to return to here, so the instruction executes forever.
+            chip8->registers.PC -= 2;
+        break;
+
+        case 0x00FE: // Low resolution (64x32).
+            chip8_screen_set_hires(&chip8->screen, false);
+        break;
+
+        case 0x00FF: // High resolution (128x64).
+            chip8_screen_set_hires(&chip8->screen, true);
+        break;
+
+        default:
+            chip8_exec_extended(chip8, opcode, quirks);
     }
 }
 
 // Function to execute a specific instruction set
 // ==> Each opcode is 8 bytes long in CHIP8, therefore it is unsigned short
-void chip8_exec(struct chip8* chip8, unsigned short opcode) {
+CHIP8_SPECIALIZED void chip8_exec_quirks(struct chip8* chip8, unsigned short opcode, const unsigned int quirks) {
     switch(opcode) {
         case 0x00E0: // Clear the display.
             chip8_screen_clear(&chip8->screen);
@@ -340,6 +553,191 @@ void chip8_exec(struct chip8* chip8, unsigned short opcode) {
         break;
 
         default: // Special case instructions where bitwise operators needa be done
-            chip8_exec_extended(chip8, opcode);
+            if (quirks & CHIP8_QUIRK_SCHIP) {
+                chip8_exec_schip(chip8, opcode, quirks);
+            } else {
+                chip8_exec_extended(chip8, opcode, quirks);
+            }
     }
-}
\ No newline at end of file
+}
+
+CHIP8_SPECIALIZED void chip8_step_quirks(struct chip8* chip8, const unsigned int quirks) {
+    // Read 2 bytes from memory from where the program counter is pointing to (Opcode), then execute opcode
+    unsigned short opcode = chip8_memory_get_short(chip8, chip8->registers.PC);
+    chip8->registers.PC += 2; // Increasing program counter by 2 to read the next 2 bytes
+    chip8_exec_quirks(chip8, opcode, quirks);
+    chip8->cycles += 1;
+}
+
+// Same as chip8_idle_run then chip8_tick_timers, with the idle loops, fused pairs and interpreter inlined
+CHIP8_SPECIALIZED void chip8_run_frame_quirks(struct chip8* chip8, const unsigned int quirks) {
+    int i = 0;
+    while (i < CHIP8_CYCLES_PER_FRAME) {
+        int executed = chip8_idle_skip_quirks(chip8, CHIP8_CYCLES_PER_FRAME - i, quirks);
+        if (executed == 0) {
+            executed = chip8_fuse_pair(chip8, CHIP8_CYCLES_PER_FRAME - i, quirks);
+        }
+        if (executed == 0) {
+            chip8_step_quirks(chip8, quirks);
+            executed = 1;
+        }
+        i += executed;
+    }
+    chip8_tick_timers(chip8);
+}
+
+// Instantiates the interpreter for one combination of quirks
+#define CHIP8_INTERPRETER(quirks) \
+    static void chip8_exec_##quirks(struct chip8* chip8, unsigned short opcode) { \
+        chip8_exec_quirks(chip8, opcode, quirks); \
+    } \
+    static int chip8_run_##quirks(struct chip8* chip8, int cycles) { \
+        for (int i = 0; i < cycles; i++) { \
+            chip8_step_quirks(chip8, quirks); \
+        } \
+        return cycles; \
+    } \
+    static void chip8_run_frame_##quirks(struct chip8* chip8) { \
+        chip8_run_frame_quirks(chip8, quirks); \
+    }
+
+CHIP8_INTERPRETER(0) CHIP8_INTERPRETER(1) CHIP8_INTERPRETER(2) CHIP8_INTERPRETER(3)
+CHIP8_INTERPRETER(4) CHIP8_INTERPRETER(5) CHIP8_INTERPRETER(6) CHIP8_INTERPRETER(7)
+CHIP8_INTERPRETER(8) CHIP8_INTERPRETER(9) CHIP8_INTERPRETER(10) CHIP8_INTERPRETER(11)
+CHIP8_INTERPRETER(12) CHIP8_INTERPRETER(13) CHIP8_INTERPRETER(14) CHIP8_INTERPRETER(15)
+CHIP8_INTERPRETER(16) CHIP8_INTERPRETER(17) CHIP8_INTERPRETER(18) CHIP8_INTERPRETER(19)
+CHIP8_INTERPRETER(20) CHIP8_INTERPRETER(21) CHIP8_INTERPRETER(22) CHIP8_INTERPRETER(23)
+CHIP8_INTERPRETER(24) CHIP8_INTERPRETER(25) CHIP8_INTERPRETER(26) CHIP8_INTERPRETER(27)
+CHIP8_INTERPRETER(28) CHIP8_INTERPRETER(29) CHIP8_INTERPRETER(30) CHIP8_INTERPRETER(31)
+CHIP8_INTERPRETER(32) CHIP8_INTERPRETER(33) CHIP8_INTERPRETER(34) CHIP8_INTERPRETER(35)
+CHIP8_INTERPRETER(36) CHIP8_INTERPRETER(37) CHIP8_INTERPRETER(38) CHIP8_INTERPRETER(39)
+CHIP8_INTERPRETER(40) CHIP8_INTERPRETER(41) CHIP8_INTERPRETER(42) CHIP8_INTERPRETER(43)
+CHIP8_INTERPRETER(44) CHIP8_INTERPRETER(45) CHIP8_INTERPRETER(46) CHIP8_INTERPRETER(47)
+CHIP8_INTERPRETER(48) CHIP8_INTERPRETER(49) CHIP8_INTERPRETER(50) CHIP8_INTERPRETER(51)
+CHIP8_INTERPRETER(52) CHIP8_INTERPRETER(53) CHIP8_INTERPRETER(54) CHIP8_INTERPRETER(55)
+CHIP8_INTERPRETER(56) CHIP8_INTERPRETER(57) CHIP8_INTERPRETER(58) CHIP8_INTERPRETER(59)
+CHIP8_INTERPRETER(60) CHIP8_INTERPRETER(61) CHIP8_INTERPRETER(62) CHIP8_INTERPRETER(63)
+
+// Indexed by chip8->quirks
+static void (*const chip8_exec_profiles[CHIP8_TOTAL_QUIRK_COMBINATIONS])(struct chip8*, unsigned short) = {
+    chip8_exec_0, chip8_exec_1, chip8_exec_2, chip8_exec_3, chip8_exec_4, chip8_exec_5, chip8_exec_6, chip8_exec_7,
+    chip8_exec_8, chip8_exec_9, chip8_exec_10, chip8_exec_11, chip8_exec_12, chip8_exec_13, chip8_exec_14, chip8_exec_15,
+    chip8_exec_16, chip8_exec_17, chip8_exec_18, chip8_exec_19, chip8_exec_20, chip8_exec_21, chip8_exec_22, chip8_exec_23,
+    chip8_exec_24, chip8_exec_25, chip8_exec_26, chip8_exec_27, chip8_exec_28, chip8_exec_29, chip8_exec_30, chip8_exec_31,
+    chip8_exec_32, chip8_exec_33, chip8_exec_34, chip8_exec_35, chip8_exec_36, chip8_exec_37, chip8_exec_38, chip8_exec_39,
+    chip8_exec_40, chip8_exec_41, chip8_exec_42, chip8_exec_43, chip8_exec_44, chip8_exec_45, chip8_exec_46, chip8_exec_47,
+    chip8_exec_48, chip8_exec_49, chip8_exec_50, chip8_exec_51, chip8_exec_52, chip8_exec_53, chip8_exec_54, chip8_exec_55,
+    chip8_exec_56, chip8_exec_57, chip8_exec_58, chip8_exec_59, chip8_exec_60, chip8_exec_61, chip8_exec_62, chip8_exec_63,
+};
+
+static int (*const chip8_run_profiles[CHIP8_TOTAL_QUIRK_COMBINATIONS])(struct chip8*, int) = {
+    chip8_run_0, chip8_run_1, chip8_run_2, chip8_run_3, chip8_run_4, chip8_run_5, chip8_run_6, chip8_run_7,
+    chip8_run_8, chip8_run_9, chip8_run_10, chip8_run_11, chip8_run_12, chip8_run_13, chip8_run_14, chip8_run_15,
+    chip8_run_16, chip8_run_17, chip8_run_18, chip8_run_19, chip8_run_20, chip8_run_21, chip8_run_22, chip8_run_23,
+    chip8_run_24, chip8_run_25, chip8_run_26, chip8_run_27, chip8_run_28, chip8_run_29, chip8_run_30, chip8_run_31,
+    chip8_run_32, chip8_run_33, chip8_run_34, chip8_run_35, chip8_run_36, chip8_run_37, chip8_run_38, chip8_run_39,
+    chip8_run_40, chip8_run_41, chip8_run_42, chip8_run_43, chip8_run_44, chip8_run_45, chip8_run_46, chip8_run_47,
+    chip8_run_48, chip8_run_49, chip8_run_50, chip8_run_51, chip8_run_52, chip8_run_53, chip8_run_54, chip8_run_55,
+    chip8_run_56, chip8_run_57, chip8_run_58, chip8_run_59, chip8_run_60, chip8_run_61, chip8_run_62, chip8_run_63,
+};
+
+static void (*const chip8_run_frame_profiles[CHIP8_TOTAL_QUIRK_COMBINATIONS])(struct chip8*) = {
+    chip8_run_frame_0, chip8_run_frame_1, chip8_run_frame_2, chip8_run_frame_3, chip8_run_frame_4, chip8_run_frame_5,
+    chip8_run_frame_6, chip8_run_frame_7, chip8_run_frame_8, chip8_run_frame_9, chip8_run_frame_10, chip8_run_frame_11,
+    chip8_run_frame_12, chip8_run_frame_13, chip8_run_frame_14, chip8_run_frame_15, chip8_run_frame_16,
+    chip8_run_frame_17, chip8_run_frame_18, chip8_run_frame_19, chip8_run_frame_20, chip8_run_frame_21,
+    chip8_run_frame_22, chip8_run_frame_23, chip8_run_frame_24, chip8_run_frame_25, chip8_run_frame_26,
+    chip8_run_frame_27, chip8_run_frame_28, chip8_run_frame_29, chip8_run_frame_30, chip8_run_frame_31,
+    chip8_run_frame_32, chip8_run_frame_33, chip8_run_frame_34, chip8_run_frame_35, chip8_run_frame_36,
+    chip8_run_frame_37, chip8_run_frame_38, chip8_run_frame_39, chip8_run_frame_40, chip8_run_frame_41,
+    chip8_run_frame_42, chip8_run_frame_43, chip8_run_frame_44, chip8_run_frame_45, chip8_run_frame_46,
+    chip8_run_frame_47, chip8_run_frame_48, chip8_run_frame_49, chip8_run_frame_50, chip8_run_frame_51,
+    chip8_run_frame_52, chip8_run_frame_53, chip8_run_frame_54, chip8_run_frame_55, chip8_run_frame_56,
+    chip8_run_frame_57, chip8_run_frame_58, chip8_run_frame_59, chip8_run_frame_60, chip8_run_frame_61,
+    chip8_run_frame_62, chip8_run_frame_63,
+};
+
+void chip8_exec(struct chip8* chip8, unsigned short opcode) {
+    chip8_exec_profiles[chip8->quirks](chip8, opcode);
+}
+
+void chip8_step(struct chip8* chip8) {
+    unsigned short opcode = chip8_memory_get_short(chip8, chip8->registers.PC);
+    chip8->registers.PC += 2;
+    chip8_exec_profiles[chip8->quirks](chip8, opcode);
+    chip8->cycles += 1;
+}
+
+int chip8_run(struct chip8* chip8, int cycles) {
+    return chip8_run_profiles[chip8->quirks](chip8, cycles);
+}
+
+static const struct chip8_quirk_profile chip8_quirk_profiles[] = {
+    { "default", 0 },
+    { "cosmac", CHIP8_QUIRK_SHIFT_VY | CHIP8_QUIRK_LOAD_STORE_I | CHIP8_QUIRK_CLIP_SPRITES },
+    { "schip", CHIP8_QUIRK_JUMP_VX | CHIP8_QUIRK_CLIP_SPRITES | CHIP8_QUIRK_SCHIP },
+    { "xochip", CHIP8_QUIRK_SHIFT_VY | CHIP8_QUIRK_LOAD_STORE_I | CHIP8_QUIRK_XO_CHIP | CHIP8_QUIRK_SCHIP },
+};
+
+#define CHIP8_TOTAL_QUIRK_PROFILES (int)(sizeof(chip8_quirk_profiles) / sizeof(chip8_quirk_profiles[0]))
+
+const struct chip8_quirk_profile* chip8_quirk_profile_find(const char* name) {
+    for (int i = 0; i < CHIP8_TOTAL_QUIRK_PROFILES; i++) {
+        if (strcmp(chip8_quirk_profiles[i].name, name) == 0) {
+            return &chip8_quirk_profiles[i];
+        }
+    }
+    return NULL;
+}
+
+const struct chip8_quirk_profile* chip8_quirk_profile_get(int index) {
+    if (index < 0 || index >= CHIP8_TOTAL_QUIRK_PROFILES) {
+        return NULL;
+    }
+    return &chip8_quirk_profiles[index];
+}
+
+int chip8_set_quirks(struct chip8* chip8, unsigned char quirks) {
+    if ((quirks & CHIP8_QUIRK_XO_CHIP) && chip8->memory.capacity < CHIP8_XO_MEMORY_SIZE) {
+        return -1;
+    }
+    chip8->quirks = quirks & (CHIP8_TOTAL_QUIRK_COMBINATIONS - 1);
+
+    // Memory past CHIP8_MEMORY_SIZE may be left over from an earlier XO-CHIP run, or never written at all after a copy
+    if ((chip8->quirks & CHIP8_QUIRK_XO_CHIP) && chip8->memory.mask != CHIP8_XO_MEMORY_SIZE - 1) {
+        memset(&chip8->memory.memory[CHIP8_MEMORY_SIZE], 0, CHIP8_XO_MEMORY_SIZE - CHIP8_MEMORY_SIZE);
+    }
+
+    // Selecting the memory size here, rather than checking for XO-CHIP on every access, keeps plain ROMs as fast as before
+    chip8->memory.mask = (chip8->quirks & CHIP8_QUIRK_XO_CHIP ? CHIP8_XO_MEMORY_SIZE : CHIP8_MEMORY_SIZE) - 1;
+    chip8->run_frame = chip8_run_frame_profiles[chip8->quirks];
+
+    // In the interpreter area, so a ROM already loaded is left untouched
+    if (chip8->quirks & CHIP8_QUIRK_SCHIP) {
+        memcpy(&chip8->memory.memory[CHIP8_BIG_CHARACTER_SET_LOAD_ADDRESS], chip8_big_character_set, sizeof(chip8_big_character_set));
+    }
+    return 0;
+}
+
+size_t chip8_size(const struct chip8* chip8) {
+    return offsetof(struct chip8, memory.memory) + chip8_memory_size(&chip8->memory);
+}
+
+void chip8_copy(struct chip8* dst, const struct chip8* src) {
+    memcpy(dst, src, chip8_size(src));
+    dst->memory.capacity = chip8_memory_size(&src->memory);
+}
+
+void chip8_tick_timers(struct chip8* chip8) {
+    if (chip8->registers.delay_timer > 0) {
+        chip8->registers.delay_timer -= 1;
+    }
+
+    if (chip8->registers.sound_timer > 0) {
+        chip8->registers.sound_timer -= 1;
+    }
+}
+
+void chip8_run_frame(struct chip8* chip8) {
+    chip8->run_frame(chip8);
+}
@@ -0,0 +1,363 @@
+#include "chip8analysis.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHIP8_ANALYSIS_UNKNOWN_I -1
+
+static unsigned short chip8_analysis_opcode(const struct chip8* chip8, unsigned short address) {
+    return chip8->memory.memory[address] << 8 | chip8->memory.memory[address + 1];
+}
+
+static bool chip8_analysis_in_memory(const struct chip8* chip8, int address) {
+    return address >= 0 && (size_t) address + 1 < chip8_memory_size(&chip8->memory);
+}
+
+// Size of the instruction at address: XO-CHIP's F000 nnnn is the only one taking 4 bytes
+static int chip8_analysis_width(const struct chip8* chip8, unsigned short address) {
+    bool long_load = (chip8->quirks & CHIP8_QUIRK_XO_CHIP) && chip8_analysis_in_memory(chip8, address) &&
+        chip8_analysis_opcode(chip8, address) == 0xF000;
+    return long_load ? 4 : 2;
+}
+
+// Whether the instruction ends a block, and which addresses may be executed after it
+static bool chip8_analysis_branch(const struct chip8* chip8, unsigned short opcode, unsigned short pc, struct chip8_block* block) {
+    unsigned short nnn = opcode & 0x0fff;
+    block->successor_count = 0;
+    block->returns = false;
+    block->computed = false;
+
+    switch (opcode & 0xf000) {
+        case 0x0000:
+            if (opcode == 0x00EE) {
+                block->returns = true;
+                return true;
+            }
+            return opcode == 0x00FD && (chip8->quirks & CHIP8_QUIRK_SCHIP); // Exit, nothing runs after it
+
+        case 0x1000:
+            block->successors[block->successor_count++] = nnn;
+            return true;
+
+        // The block after a call is where the subroutine returns to
+        case 0x2000:
+            block->successors[block->successor_count++] = nnn;
+            block->successors[block->successor_count++] = pc + 2;
+            return true;
+
+        // 5xy2 / 5xy3 (XO-CHIP) share their first digit with 5xy0 but do not skip
+        case 0x5000:
+            if ((opcode & 0x000f) != 0) {
+                return false;
+            }
+        // fall through
+        case 0x3000:
+        case 0x4000:
+        case 0x9000:
+        case 0xE000:
+            block->successors[block->successor_count++] = pc + 2;
+            block->successors[block->successor_count++] = pc + 2 + chip8_analysis_width(chip8, pc + 2);
+            return true;
+
+        case 0xB000:
+            block->computed = true;
+            return true;
+    }
+
+    return false;
+}
+
+// SUPER-CHIP and XO-CHIP instructions are only valid with CHIP8_QUIRK_SCHIP / CHIP8_QUIRK_XO_CHIP in the quirks
+static bool chip8_analysis_valid(unsigned short opcode, unsigned int quirks) {
+    bool schip = quirks & CHIP8_QUIRK_SCHIP;
+    bool xo = quirks & CHIP8_QUIRK_XO_CHIP;
+
+    switch (opcode & 0xf000) {
+        case 0x5000:
+            return (opcode & 0x000f) == 0 || (xo && ((opcode & 0x000f) == 0x2 || (opcode & 0x000f) == 0x3));
+
+        case 0x9000:
+            return (opcode & 0x000f) == 0;
+
+        case 0x8000:
+            return (opcode & 0x000f) <= 0x7 || (opcode & 0x000f) == 0xE;
+
+        case 0xE000:
+            return (opcode & 0x00ff) == 0x9E || (opcode & 0x00ff) == 0xA1;
+
+        case 0xF000:
+            switch (opcode & 0x00ff) {
+                case 0x07: case 0x0A: case 0x15: case 0x18: case 0x1E: case 0x29: case 0x33: case 0x55: case 0x65:
+                    return true;
+                case 0x30: case 0x75: case 0x85:
+                    return schip;
+                case 0x01: case 0x3A:
+                    return xo;
+                case 0x00: case 0x02:
+                    return xo && (opcode & 0x0f00) == 0;
+            }
+            return false;
+    }
+
+    return true;
+}
+
+static void chip8_analysis_mark(const struct chip8* chip8, struct chip8_analysis* analysis, int address, int count, unsigned char flag) {
+    for (int i = 0; i < count && (size_t) (address + i) < chip8_memory_size(&chip8->memory); i++) {
+        analysis->flags[address + i] |= flag;
+    }
+}
+
+// Finds every reachable instruction, following the successors of each branch
+static void chip8_analysis_find_code(const struct chip8* chip8, struct chip8_analysis* analysis) {
+    static unsigned short worklist[CHIP8_XO_MEMORY_SIZE * 2];
+    size_t pending = 0;
+    struct chip8_block branch;
+
+    worklist[pending++] = CHIP8_PROGRAM_LOAD_ADDRESS;
+    analysis->flags[CHIP8_PROGRAM_LOAD_ADDRESS] |= CHIP8_ANALYSIS_LEADER;
+
+    while (pending > 0) {
+        unsigned short pc = worklist[--pending];
+
+        while (chip8_analysis_in_memory(chip8, pc) && !(analysis->flags[pc] & CHIP8_ANALYSIS_CODE)) {
+            unsigned short opcode = chip8_analysis_opcode(chip8, pc);
+            int width = chip8_analysis_width(chip8, pc);
+            analysis->flags[pc] |= CHIP8_ANALYSIS_CODE;
+            chip8_analysis_mark(chip8, analysis, pc + 1, width - 1, CHIP8_ANALYSIS_OPERAND);
+            analysis->instruction_count += 1;
+
+            if (!chip8_analysis_valid(opcode, chip8->quirks)) {
+                analysis->invalid_count += 1;
+            }
+
+            if (!chip8_analysis_branch(chip8, opcode, pc, &branch)) {
+                pc += width;
+                continue;
+            }
+
+            analysis->computed_jumps |= branch.computed;
+            if ((opcode & 0xf000) == 0x2000) {
+                analysis->flags[opcode & 0x0fff] |= CHIP8_ANALYSIS_CALL_TARGET;
+            }
+
+            for (int i = 0; i < branch.successor_count; i++) {
+                unsigned short next = branch.successors[i];
+                if (chip8_analysis_in_memory(chip8, next)) {
+                    analysis->flags[next] |= CHIP8_ANALYSIS_LEADER;
+                    worklist[pending++] = next;
+                }
+            }
+            break;
+        }
+    }
+}
+
+// Follows I through one block to mark the memory it reads and writes
+static void chip8_analysis_track_i(const struct chip8* chip8, struct chip8_analysis* analysis, const struct chip8_block* block) {
+    int I = CHIP8_ANALYSIS_UNKNOWN_I;
+
+    for (unsigned short pc = block->start; pc < block->end; pc += chip8_analysis_width(chip8, pc)) {
+        unsigned short opcode = chip8_analysis_opcode(chip8, pc);
+        unsigned char x = (opcode >> 8) & 0x000f;
+
+        if ((opcode & 0xf000) == 0xA000) {
+            I = opcode & 0x0fff;
+        } else if (chip8_analysis_width(chip8, pc) == 4) {
+            I = chip8_analysis_opcode(chip8, pc + 2);
+        } else if ((chip8->quirks & CHIP8_QUIRK_XO_CHIP) && (opcode & 0xf00f) == 0x5002) {
+            int count = abs(x - ((opcode >> 4) & 0x000f)) + 1;
+            if (I == CHIP8_ANALYSIS_UNKNOWN_I) {
+                analysis->unknown_writes = true;
+            } else {
+                chip8_analysis_mark(chip8, analysis, I, count, CHIP8_ANALYSIS_WRITTEN);
+            }
+        } else if ((chip8->quirks & CHIP8_QUIRK_XO_CHIP) && (opcode & 0xf00f) == 0x5003) {
+            if (I != CHIP8_ANALYSIS_UNKNOWN_I) {
+                chip8_analysis_mark(chip8, analysis, I, abs(x - ((opcode >> 4) & 0x000f)) + 1, CHIP8_ANALYSIS_DATA);
+            }
+        } else if ((chip8->quirks & CHIP8_QUIRK_XO_CHIP) && opcode == 0xF002) {
+            if (I != CHIP8_ANALYSIS_UNKNOWN_I) {
+                chip8_analysis_mark(chip8, analysis, I, CHIP8_AUDIO_PATTERN_SIZE, CHIP8_ANALYSIS_DATA);
+            }
+        } else if ((opcode & 0xf000) == 0xD000) {
+            // Dxy0 is a 16x16 sprite in high resolution
+            if (I != CHIP8_ANALYSIS_UNKNOWN_I) {
+                chip8_analysis_mark(chip8, analysis, I, opcode & 0x000f ? opcode & 0x000f : 32, CHIP8_ANALYSIS_DATA);
+            }
+        } else if ((opcode & 0xf000) == 0xF000) {
+            switch (opcode & 0x00ff) {
+                case 0x1E:
+                case 0x29:
+                case 0x30:
+                    I = CHIP8_ANALYSIS_UNKNOWN_I;
+                break;
+
+                // Fx33 goes on to store V0 - Vx like Fx55 does
+                case 0x33:
+                case 0x55:
+                {
+                    int count = (opcode & 0x00ff) == 0x33 && x < 2 ? 3 : x + 1;
+                    if (I == CHIP8_ANALYSIS_UNKNOWN_I) {
+                        analysis->unknown_writes = true;
+                    } else {
+                        chip8_analysis_mark(chip8, analysis, I, count, CHIP8_ANALYSIS_WRITTEN);
+                    }
+                    if (chip8->quirks & CHIP8_QUIRK_LOAD_STORE_I) {
+                        I = CHIP8_ANALYSIS_UNKNOWN_I;
+                    }
+                }
+                break;
+
+                case 0x65:
+                    if (I != CHIP8_ANALYSIS_UNKNOWN_I) {
+                        chip8_analysis_mark(chip8, analysis, I, x + 1, CHIP8_ANALYSIS_DATA);
+                    }
+                    if (chip8->quirks & CHIP8_QUIRK_LOAD_STORE_I) {
+                        I = CHIP8_ANALYSIS_UNKNOWN_I;
+                    }
+                break;
+            }
+        }
+    }
+}
+
+// Splits the reachable code into blocks, each running from a leader to the first branch or the next leader
+static void chip8_analysis_find_blocks(const struct chip8* chip8, struct chip8_analysis* analysis) {
+    for (size_t start = 0; start < analysis->memory_size && analysis->block_count < CHIP8_ANALYSIS_MAX_BLOCKS; start++) {
+        if (!(analysis->flags[start] & CHIP8_ANALYSIS_LEADER) || !(analysis->flags[start] & CHIP8_ANALYSIS_CODE)) {
+            continue;
+        }
+
+        struct chip8_block* block = &analysis->blocks[analysis->block_count++];
+        block->start = start;
+
+        unsigned short pc = start;
+        while (true) {
+            int width = chip8_analysis_width(chip8, pc);
+            if (chip8_analysis_branch(chip8, chip8_analysis_opcode(chip8, pc), pc, block)) {
+                pc += width;
+                break;
+            }
+
+            // Falls through into the next block
+            pc += width;
+            if (!chip8_analysis_in_memory(chip8, pc) || !(analysis->flags[pc] & CHIP8_ANALYSIS_CODE) || (analysis->flags[pc] & CHIP8_ANALYSIS_LEADER)) {
+                if (chip8_analysis_in_memory(chip8, pc)) {
+                    block->successors[block->successor_count++] = pc;
+                }
+                break;
+            }
+        }
+        block->end = pc;
+
+        chip8_analysis_track_i(chip8, analysis, block);
+    }
+}
+
+void chip8_analyze(const struct chip8* chip8, struct chip8_analysis* analysis) {
+    memset(analysis, 0, sizeof(struct chip8_analysis));
+    analysis->memory_size = chip8_memory_size(&chip8->memory);
+    chip8_analysis_find_code(chip8, analysis);
+    chip8_analysis_find_blocks(chip8, analysis);
+
+    for (size_t i = 0; i < analysis->memory_size; i++) {
+        if ((analysis->flags[i] & CHIP8_ANALYSIS_WRITTEN) && (analysis->flags[i] & (CHIP8_ANALYSIS_CODE | CHIP8_ANALYSIS_OPERAND))) {
+            analysis->self_modifying = true;
+        }
+    }
+}
+
+const struct chip8_block* chip8_analysis_block(const struct chip8_analysis* analysis, unsigned short address) {
+    size_t low = 0;
+    size_t high = analysis->block_count;
+
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (analysis->blocks[mid].start < address) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low < analysis->block_count && analysis->blocks[low].start == address ? &analysis->blocks[low] : NULL;
+}
+
+bool chip8_disassemble(unsigned short opcode, char* out, size_t size) {
+    unsigned short nnn = opcode & 0x0fff;
+    unsigned char x = (opcode >> 8) & 0x000f;
+    unsigned char y = (opcode >> 4) & 0x000f;
+    unsigned char kk = opcode & 0x00ff;
+    unsigned char n = opcode & 0x000f;
+
+    static const char* const eight[16] = {
+        "LD", "OR", "AND", "XOR", "ADD", "SUB", "SHR", "SUBN", NULL, NULL, NULL, NULL, NULL, NULL, "SHL", NULL
+    };
+
+    if (!chip8_analysis_valid(opcode, CHIP8_QUIRK_XO_CHIP | CHIP8_QUIRK_SCHIP)) {
+        snprintf(out, size, "DW 0x%04x", opcode);
+        return false;
+    }
+
+    switch (opcode & 0xf000) {
+        case 0x0000:
+            if (opcode == 0x00E0) {
+                snprintf(out, size, "CLS");
+            } else if (opcode == 0x00EE) {
+                snprintf(out, size, "RET");
+            } else if ((opcode & 0xfff0) == 0x00C0) {
+                snprintf(out, size, "SCD %d", n);
+            } else if ((opcode & 0xfff0) == 0x00D0) {
+                snprintf(out, size, "SCU %d", n);
+            } else if (opcode >= 0x00FB && opcode <= 0x00FF) {
+                static const char* const schip[] = { "SCR", "SCL", "EXIT", "LOW", "HIGH" };
+                snprintf(out, size, "%s", schip[opcode - 0x00FB]);
+            } else {
+                snprintf(out, size, "SYS 0x%03x", nnn);
+            }
+        break;
+        case 0x1000: snprintf(out, size, "JP 0x%03x", nnn); break;
+        case 0x2000: snprintf(out, size, "CALL 0x%03x", nnn); break;
+        case 0x3000: snprintf(out, size, "SE V%X, 0x%02x", x, kk); break;
+        case 0x4000: snprintf(out, size, "SNE V%X, 0x%02x", x, kk); break;
+        case 0x5000:
+            if (n == 0x2 || n == 0x3) {
+                snprintf(out, size, "%s V%X - V%X", n == 0x2 ? "SAVE" : "LOAD", x, y);
+            } else {
+                snprintf(out, size, "SE V%X, V%X", x, y);
+            }
+        break;
+        case 0x6000: snprintf(out, size, "LD V%X, 0x%02x", x, kk); break;
+        case 0x7000: snprintf(out, size, "ADD V%X, 0x%02x", x, kk); break;
+        case 0x8000: snprintf(out, size, "%s V%X, V%X", eight[n], x, y); break;
+        case 0x9000: snprintf(out, size, "SNE V%X, V%X", x, y); break;
+        case 0xA000: snprintf(out, size, "LD I, 0x%03x", nnn); break;
+        case 0xB000: snprintf(out, size, "JP V0, 0x%03x", nnn); break;
+        case 0xC000: snprintf(out, size, "RND V%X, 0x%02x", x, kk); break;
+        case 0xD000: snprintf(out, size, "DRW V%X, V%X, %d", x, y, n); break;
+        case 0xE000: snprintf(out, size, "%s V%X", kk == 0x9E ? "SKP" : "SKNP", x); break;
+        case 0xF000:
+            switch (kk) {
+                case 0x00: snprintf(out, size, "LD I, long"); break;
+                case 0x01: snprintf(out, size, "PLANE %d", x); break;
+                case 0x02: snprintf(out, size, "AUDIO"); break;
+                case 0x3A: snprintf(out, size, "PITCH V%X", x); break;
+                case 0x07: snprintf(out, size, "LD V%X, DT", x); break;
+                case 0x0A: snprintf(out, size, "LD V%X, K", x); break;
+                case 0x15: snprintf(out, size, "LD DT, V%X", x); break;
+                case 0x18: snprintf(out, size, "LD ST, V%X", x); break;
+                case 0x1E: snprintf(out, size, "ADD I, V%X", x); break;
+                case 0x29: snprintf(out, size, "LD F, V%X", x); break;
+                case 0x30: snprintf(out, size, "LD HF, V%X", x); break;
+                case 0x33: snprintf(out, size, "LD B, V%X", x); break;
+                case 0x55: snprintf(out, size, "LD [I], V%X", x); break;
+                case 0x65: snprintf(out, size, "LD V%X, [I]", x); break;
+                case 0x75: snprintf(out, size, "LD R, V%X", x); break;
+                case 0x85: snprintf(out, size, "LD V%X, R", x); break;
+            }
+        break;
+    }
+
+    return true;
+}
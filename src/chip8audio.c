@@ -0,0 +1,81 @@
+#include "chip8audio.h"
+#include <string.h>
+
+#define CHIP8_AUDIO_PATTERN_BITS (CHIP8_AUDIO_PATTERN_SIZE * 8)
+
+// Runs on SDL's audio thread, with the device locked
+static void chip8_audio_callback(void* userdata, Uint8* stream, int len) {
+    struct chip8_audio* audio = userdata;
+    Sint16* samples = (Sint16*) stream;
+    int count = len / sizeof(Sint16);
+
+    for (int i = 0; i < count; i++) {
+        if (!audio->playing) {
+            samples[i] = 0;
+            continue;
+        }
+
+        // Each pattern bit is one sample of a 1 bit waveform, most significant bit first
+        int bit = (int) audio->position;
+        bool high = (audio->pattern[bit / 8] >> (7 - bit % 8)) & 1;
+        samples[i] = high ? CHIP8_AUDIO_VOLUME : -CHIP8_AUDIO_VOLUME;
+
+        audio->position += audio->step;
+        if (audio->position >= CHIP8_AUDIO_PATTERN_BITS) {
+            audio->position -= CHIP8_AUDIO_PATTERN_BITS;
+        }
+    }
+}
+
+int chip8_audio_open(struct chip8_audio* audio) {
+    memset(audio, 0, sizeof(struct chip8_audio));
+
+    SDL_AudioSpec want;
+    SDL_AudioSpec have;
+    SDL_zero(want);
+    want.freq = CHIP8_AUDIO_SAMPLE_RATE;
+    want.format = AUDIO_S16SYS;
+    want.channels = 1;
+    want.samples = 512; // About 12 ms at 44.1 kHz, short enough that the beep starts and stops with the frame
+    want.callback = chip8_audio_callback;
+    want.userdata = audio;
+
+    audio->device = SDL_OpenAudioDevice(NULL, 0, &want, &have, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+    if (audio->device == 0) {
+        return -1;
+    }
+
+    audio->sample_rate = have.freq;
+    SDL_PauseAudioDevice(audio->device, 0);
+    return 0;
+}
+
+void chip8_audio_close(struct chip8_audio* audio) {
+    if (audio->device != 0) {
+        SDL_CloseAudioDevice(audio->device);
+    }
+    memset(audio, 0, sizeof(struct chip8_audio));
+}
+
+void chip8_audio_update(struct chip8_audio* audio, const struct chip8* chip8, bool muted) {
+    if (audio->device == 0) {
+        return;
+    }
+
+    unsigned char pattern[CHIP8_AUDIO_PATTERN_SIZE];
+    double rate; // Pattern samples per second
+    if (chip8->quirks & CHIP8_QUIRK_XO_CHIP) {
+        memcpy(pattern, chip8->audio_pattern, sizeof(pattern));
+        rate = CHIP8_AUDIO_PATTERN_RATE * SDL_pow(2.0, (chip8->pitch - CHIP8_DEFAULT_PITCH) / 48.0);
+    } else {
+        // 4 samples high, 4 samples low: One period of the square wave every 8 samples
+        memset(pattern, 0xF0, sizeof(pattern));
+        rate = CHIP8_BEEP_FREQUENCY * 8.0;
+    }
+
+    SDL_LockAudioDevice(audio->device);
+    audio->playing = chip8->registers.sound_timer > 0 && !muted;
+    memcpy(audio->pattern, pattern, sizeof(pattern));
+    audio->step = rate / audio->sample_rate;
+    SDL_UnlockAudioDevice(audio->device);
+}
@@ -0,0 +1,111 @@
+#include "chip8batch.h"
+#include "chip8hash.h"
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static void chip8_batch_worker(struct chip8_job* jobs, size_t count, int workers, int shard, struct chip8_batch_result* results) {
+    for (size_t i = shard; i < count; i += workers) {
+        struct chip8_batch_result* result = &results[i];
+
+        // A job found running was the one a previous worker of this shard crashed on, it has been marked by now
+        if (__atomic_load_n(&result->status, __ATOMIC_ACQUIRE) != CHIP8_BATCH_PENDING) {
+            continue;
+        }
+        __atomic_store_n(&result->status, CHIP8_BATCH_RUNNING, __ATOMIC_RELEASE);
+
+        struct chip8_job* job = &jobs[i];
+        while (!chip8_job_run(job, job->max_frames)) {
+        }
+
+        result->frames = job->frame;
+        result->cycles = job->chip8->cycles;
+        result->hash = chip8_hash_state(job->chip8);
+        chip8_screen_pack(&job->chip8->screen, result->screen);
+        __atomic_store_n(&result->status, CHIP8_BATCH_DONE, __ATOMIC_RELEASE);
+    }
+}
+
+static pid_t chip8_batch_spawn(struct chip8_job* jobs, size_t count, int workers, int shard, struct chip8_batch_result* results) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        chip8_batch_worker(jobs, count, workers, shard, results);
+        _exit(0);
+    }
+    return pid;
+}
+
+int chip8_batch_run(struct chip8_job* jobs, size_t count, int workers, struct chip8_batch_result** results) {
+    if (workers <= 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = cores > 0 ? cores : 1;
+    }
+
+    // Anonymous shared mapping: Zero filled (Every status starts as pending) and visible to every forked worker
+    size_t size = (count > 0 ? count : 1) * sizeof(struct chip8_batch_result);
+    struct chip8_batch_result* shared = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) {
+        return -1;
+    }
+
+    pid_t* pids = calloc(workers, sizeof(pid_t));
+    if (!pids) {
+        munmap(shared, size);
+        return -1;
+    }
+
+    int running = 0;
+    for (int shard = 0; shard < workers; shard++) {
+        pids[shard] = chip8_batch_spawn(jobs, count, workers, shard, shared);
+        running += pids[shard] > 0;
+    }
+
+    int res = running == workers ? 0 : -1;
+    while (running > 0) {
+        int status;
+        pid_t pid = wait(&status);
+        if (pid < 0) {
+            res = -1;
+            break;
+        }
+
+        int shard = 0;
+        while (shard < workers && pids[shard] != pid) {
+            shard++;
+        }
+        if (shard == workers) {
+            continue;
+        }
+
+        running -= 1;
+        pids[shard] = 0;
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+            continue;
+        }
+
+        // The worker died in the middle of a job: Mark it and let a fresh worker carry on with the rest of the shard
+        for (size_t i = shard; i < count; i += workers) {
+            if (shared[i].status == CHIP8_BATCH_RUNNING) {
+                shared[i].status = CHIP8_BATCH_CRASHED;
+            }
+        }
+
+        pids[shard] = chip8_batch_spawn(jobs, count, workers, shard, shared);
+        running += pids[shard] > 0;
+    }
+
+    free(pids);
+
+    if (res != 0) {
+        munmap(shared, size);
+        return -1;
+    }
+
+    *results = shared;
+    return 0;
+}
+
+void chip8_batch_free(struct chip8_batch_result* results, size_t count) {
+    munmap(results, (count > 0 ? count : 1) * sizeof(struct chip8_batch_result));
+}
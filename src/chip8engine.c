@@ -0,0 +1,64 @@
+#include "chip8engine.h"
+#include "chip8.h"
+#include "chip8pool.h"
+#include "chip8idle.h"
+#include "chip8fuse.h"
+#include <string.h>
+
+static int chip8_engine_reference_run(struct chip8* chip8, int cycles, void* context) {
+    (void) context;
+    return chip8_run(chip8, cycles);
+}
+
+static int chip8_engine_idle_run(struct chip8* chip8, int cycles, void* context) {
+    (void) context;
+    return chip8_idle_run(chip8, cycles);
+}
+
+static int chip8_engine_fused_run(struct chip8* chip8, int cycles, void* context) {
+    (void) context;
+    return chip8_fuse_run(chip8, cycles);
+}
+
+// Runs the chip8 as the only instance of a pool, so the pool interpreter can be checked against the reference
+static int chip8_engine_pool_run(struct chip8* chip8, int cycles, void* context) {
+    (void) context;
+    static struct chip8_pool pool;
+    if (pool.count == 0 && chip8_pool_init(&pool, 1) != 0) {
+        return 0;
+    }
+
+    // Refused (No progress) for anything but the default profile
+    if (chip8_pool_set(&pool, 0, chip8) != 0) {
+        return 0;
+    }
+    chip8_pool_run(&pool, cycles);
+    chip8_pool_get(&pool, 0, chip8);
+    return cycles;
+}
+
+// Every engine that should be selectable by name (e.g. from the lockstep runner) is listed here
+static const struct chip8_engine chip8_engines[] = {
+    { "reference", chip8_engine_reference_run, NULL },
+    { "pool", chip8_engine_pool_run, NULL },
+    { "idle", chip8_engine_idle_run, NULL },
+    { "fused", chip8_engine_fused_run, NULL },
+};
+
+#define CHIP8_TOTAL_ENGINES (int)(sizeof(chip8_engines) / sizeof(chip8_engines[0]))
+
+const struct chip8_engine* chip8_engine_find(const char* name) {
+    for (int i = 0; i < CHIP8_TOTAL_ENGINES; i++) {
+        if (strcmp(chip8_engines[i].name, name) == 0) {
+            return &chip8_engines[i];
+        }
+    }
+    return NULL;
+}
+
+const struct chip8_engine* chip8_engine_get(int index) {
+    if (index < 0 || index >= CHIP8_TOTAL_ENGINES) {
+        return NULL;
+    }
+    return &chip8_engines[index];
+}
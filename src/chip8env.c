@@ -0,0 +1,84 @@
+#include "chip8env.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CHIP8_ENV_VM(envs, i) ((struct chip8*) ((envs)->vms + (i) * (envs)->stride))
+
+int chip8_env_init(struct chip8_envs* envs, size_t count, const struct chip8* initial, unsigned long max_frames,
+    float* rewards, unsigned char* observations, bool* dones) {
+    memset(envs, 0, sizeof(struct chip8_envs));
+    envs->count = count;
+    envs->max_frames = max_frames;
+    envs->rewards = rewards;
+    envs->observations = observations;
+    envs->dones = dones;
+
+    // Plain CHIP-8 instances only take 4 KB of memory each, XO-CHIP ones 64 KB
+    envs->stride = (chip8_size(initial) + _Alignof(struct chip8) - 1) / _Alignof(struct chip8) * _Alignof(struct chip8);
+    envs->initial = malloc(chip8_size(initial));
+    envs->vms = malloc(count * envs->stride);
+    envs->frames = malloc(count * sizeof(unsigned long));
+    envs->scores = malloc(count * sizeof(float));
+    if (!envs->initial || !envs->vms || !envs->frames || !envs->scores) {
+        chip8_env_free(envs);
+        return -1;
+    }
+    chip8_copy(envs->initial, initial);
+
+    for (size_t i = 0; i < count; i++) {
+        chip8_env_reset(envs, i);
+    }
+    return 0;
+}
+
+void chip8_env_free(struct chip8_envs* envs) {
+    free(envs->initial);
+    free(envs->vms);
+    free(envs->frames);
+    free(envs->scores);
+    envs->initial = NULL;
+    envs->vms = NULL;
+    envs->frames = NULL;
+    envs->scores = NULL;
+    envs->count = 0;
+}
+
+void chip8_env_set_score(struct chip8_envs* envs, chip8_env_score_fn score, void* user) {
+    envs->score = score;
+    envs->user = user;
+    for (size_t i = 0; i < envs->count; i++) {
+        envs->scores[i] = score ? score(CHIP8_ENV_VM(envs, i), user) : 0;
+    }
+}
+
+void chip8_env_reset(struct chip8_envs* envs, size_t index) {
+    struct chip8* chip8 = CHIP8_ENV_VM(envs, index);
+    chip8_copy(chip8, envs->initial);
+    envs->frames[index] = 0;
+    envs->scores[index] = envs->score ? envs->score(chip8, envs->user) : 0;
+    envs->rewards[index] = 0;
+    envs->dones[index] = false;
+    chip8_screen_pack(&chip8->screen, envs->observations + index * CHIP8_SCREEN_PACKED_SIZE);
+}
+
+void chip8_env_step(struct chip8_envs* envs, const unsigned short* actions, size_t n) {
+    if (n > envs->count) {
+        n = envs->count;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        struct chip8* chip8 = CHIP8_ENV_VM(envs, i);
+        for (int k = 0; k < CHIP8_TOTAL_KEYS; k++) {
+            chip8->keyboard.keyboard[k] = (actions[i] >> k) & 1;
+        }
+
+        chip8_run_frame(chip8);
+        envs->frames[i] += 1;
+
+        float score = envs->score ? envs->score(chip8, envs->user) : 0;
+        envs->rewards[i] = score - envs->scores[i];
+        envs->scores[i] = score;
+        envs->dones[i] = envs->max_frames && envs->frames[i] >= envs->max_frames;
+        chip8_screen_pack(&chip8->screen, envs->observations + i * CHIP8_SCREEN_PACKED_SIZE);
+    }
+}
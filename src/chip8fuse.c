@@ -0,0 +1,18 @@
+#include "chip8fuse.h"
+
+// Anything but the start of a fused pair goes through the reference interpreter, matching chip8->quirks
+int chip8_fuse_step(struct chip8* chip8, int cycles) {
+    int executed = chip8_fuse_pair(chip8, cycles, chip8->quirks);
+    if (executed == 0) {
+        chip8_step(chip8);
+        executed = 1;
+    }
+    return executed;
+}
+
+int chip8_fuse_run(struct chip8* chip8, int cycles) {
+    for (int i = 0; i < cycles;) {
+        i += chip8_fuse_step(chip8, cycles - i);
+    }
+    return cycles;
+}
@@ -0,0 +1,136 @@
+#include "chip8hash.h"
+#include "chip8.h"
+#include "chip8endian.h"
+#include "config.h"
+
+#define CHIP8_HASH_PRIME1 0x9E3779B185EBCA87ULL
+#define CHIP8_HASH_PRIME2 0xC2B2AE3D27D4EB4FULL
+#define CHIP8_HASH_PRIME3 0x165667B19E3779F9ULL
+#define CHIP8_HASH_PRIME4 0x85EBCA77C2B2AE63ULL
+#define CHIP8_HASH_PRIME5 0x27D4EB2F165667C5ULL
+
+static uint64_t chip8_hash_rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static uint64_t chip8_hash_round(uint64_t acc, uint64_t input) {
+    acc += input * CHIP8_HASH_PRIME2;
+    acc = chip8_hash_rotl(acc, 31);
+    return acc * CHIP8_HASH_PRIME1;
+}
+
+static uint64_t chip8_hash_merge_round(uint64_t acc, uint64_t val) {
+    acc ^= chip8_hash_round(0, val);
+    return acc * CHIP8_HASH_PRIME1 + CHIP8_HASH_PRIME4;
+}
+
+uint64_t chip8_hash(const void* data, size_t size, uint64_t seed) {
+    const unsigned char* p = data;
+    const unsigned char* end = p + size;
+    uint64_t h;
+
+    // Bulk of the input is consumed 32 bytes at a time by 4 independent accumulators
+    if (size >= 32) {
+        uint64_t v1 = seed + CHIP8_HASH_PRIME1 + CHIP8_HASH_PRIME2;
+        uint64_t v2 = seed + CHIP8_HASH_PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - CHIP8_HASH_PRIME1;
+
+        do {
+            v1 = chip8_hash_round(v1, chip8_get64(p));
+            v2 = chip8_hash_round(v2, chip8_get64(p + 8));
+            v3 = chip8_hash_round(v3, chip8_get64(p + 16));
+            v4 = chip8_hash_round(v4, chip8_get64(p + 24));
+            p += 32;
+        } while (p + 32 <= end);
+
+        h = chip8_hash_rotl(v1, 1) + chip8_hash_rotl(v2, 7) + chip8_hash_rotl(v3, 12) + chip8_hash_rotl(v4, 18);
+        h = chip8_hash_merge_round(h, v1);
+        h = chip8_hash_merge_round(h, v2);
+        h = chip8_hash_merge_round(h, v3);
+        h = chip8_hash_merge_round(h, v4);
+    } else {
+        h = seed + CHIP8_HASH_PRIME5;
+    }
+
+    h += (uint64_t) size;
+
+    // Remaining tail of less than 32 bytes
+    while (p + 8 <= end) {
+        h ^= chip8_hash_round(0, chip8_get64(p));
+        h = chip8_hash_rotl(h, 27) * CHIP8_HASH_PRIME1 + CHIP8_HASH_PRIME4;
+        p += 8;
+    }
+
+    if (p + 4 <= end) {
+        h ^= (uint64_t) chip8_get32(p) * CHIP8_HASH_PRIME1;
+        h = chip8_hash_rotl(h, 23) * CHIP8_HASH_PRIME2 + CHIP8_HASH_PRIME3;
+        p += 4;
+    }
+
+    while (p < end) {
+        h ^= (*p) * CHIP8_HASH_PRIME5;
+        h = chip8_hash_rotl(h, 11) * CHIP8_HASH_PRIME1;
+        p++;
+    }
+
+    // Final avalanche
+    h ^= h >> 33;
+    h *= CHIP8_HASH_PRIME2;
+    h ^= h >> 29;
+    h *= CHIP8_HASH_PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+uint64_t chip8_hash_state(const struct chip8* chip8) {
+    // Registers, stack, keys and rng are laid out in a byte buffer first, so struct padding never ends up in the hash
+    unsigned char buf[CHIP8_TOTAL_DATA_REGISTERS + 8 + CHIP8_TOTAL_STACK_DEPTH * 2 + CHIP8_TOTAL_KEYS + 4 + 1 + CHIP8_TOTAL_RPL_FLAGS +
+        1 + CHIP8_AUDIO_PATTERN_SIZE + 1];
+    unsigned char* p = buf;
+
+    for (int i = 0; i < CHIP8_TOTAL_DATA_REGISTERS; i++) {
+        *p++ = chip8->registers.V[i];
+    }
+    chip8_put16(p, chip8->registers.I);
+    chip8_put16(p + 2, chip8->registers.PC);
+    chip8_put16(p + 4, chip8->registers.SP);
+    p += 6;
+    *p++ = chip8->registers.delay_timer;
+    *p++ = chip8->registers.sound_timer;
+
+    for (int i = 0; i < CHIP8_TOTAL_STACK_DEPTH; i++) {
+        chip8_put16(p, chip8->stack.stack[i]);
+        p += 2;
+    }
+
+    for (int i = 0; i < CHIP8_TOTAL_KEYS; i++) {
+        *p++ = chip8->keyboard.keyboard[i];
+    }
+
+    chip8_put32(p, chip8->rng);
+    p += 4;
+
+    *p++ = chip8->screen.hires;
+    for (int i = 0; i < CHIP8_TOTAL_RPL_FLAGS; i++) {
+        *p++ = chip8->flags[i];
+    }
+
+    *p++ = chip8->screen.plane_mask;
+    for (int i = 0; i < CHIP8_AUDIO_PATTERN_SIZE; i++) {
+        *p++ = chip8->audio_pattern[i];
+    }
+    *p++ = chip8->pitch;
+
+    // Each part is hashed with the previous part's hash as its seed
+    uint64_t h = chip8_hash(buf, sizeof(buf), 0);
+    h = chip8_hash(chip8->memory.memory, chip8_memory_size(&chip8->memory), h);
+    unsigned char screen[CHIP8_SCREEN_PACKED_SIZE];
+    chip8_screen_pack(&chip8->screen, screen);
+    h = chip8_hash(screen, sizeof(screen), h);
+    return h;
+}
+
+void chip8_hash_stream_write(FILE* f, unsigned long frame, uint64_t hash) {
+    fprintf(f, "%lu %016llx\n", frame, (unsigned long long) hash);
+}
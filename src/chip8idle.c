@@ -0,0 +1,24 @@
+#include "chip8idle.h"
+#include "chip8fuse.h"
+
+int chip8_idle_skip(struct chip8* chip8, int cycles) {
+    return chip8_idle_skip_quirks(chip8, cycles, chip8->quirks);
+}
+
+bool chip8_idle_waiting(struct chip8* chip8) {
+    return chip8->registers.delay_timer == 0 && chip8->registers.sound_timer == 0 && chip8_idle_loop(chip8, chip8->quirks) > 0;
+}
+
+int chip8_idle_run(struct chip8* chip8, int cycles) {
+    int i = 0;
+    while (i < cycles) {
+        int skipped = chip8_idle_skip(chip8, cycles - i);
+        if (skipped > 0) {
+            i += skipped;
+            continue;
+        }
+
+        i += chip8_fuse_step(chip8, cycles - i);
+    }
+    return cycles;
+}
@@ -0,0 +1,80 @@
+#include "chip8input.h"
+#include "config.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+int chip8_input_script_load(struct chip8_input_script* script, const char* filename) {
+    script->events = NULL;
+    script->count = 0;
+    script->next = 0;
+
+    FILE* f = fopen(filename, "r");
+    if (!f) {
+        return -1;
+    }
+
+    size_t capacity = 0;
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') {
+            continue;
+        }
+
+        unsigned long frame;
+        unsigned int key;
+        char action;
+        if (sscanf(line, "%lu %x %c", &frame, &key, &action) != 3 || key >= CHIP8_TOTAL_KEYS || (action != 'd' && action != 'u')) {
+            goto fail;
+        }
+
+        // Events are applied in order, so a script going back in time would silently drop events
+        if (script->count > 0 && frame < script->events[script->count - 1].frame) {
+            goto fail;
+        }
+
+        if (script->count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            struct chip8_input_event* events = realloc(script->events, capacity * sizeof(struct chip8_input_event));
+            if (!events) {
+                goto fail;
+            }
+            script->events = events;
+        }
+
+        script->events[script->count].frame = frame;
+        script->events[script->count].key = key;
+        script->events[script->count].down = action == 'd';
+        script->count += 1;
+    }
+
+    fclose(f);
+    return 0;
+
+fail:
+    fclose(f);
+    chip8_input_script_free(script);
+    return -1;
+}
+
+void chip8_input_script_free(struct chip8_input_script* script) {
+    free(script->events);
+    script->events = NULL;
+    script->count = 0;
+    script->next = 0;
+}
+
+void chip8_input_script_rewind(struct chip8_input_script* script) {
+    script->next = 0;
+}
+
+void chip8_input_script_apply(struct chip8_input_script* script, struct chip8_keyboard* keyboard, unsigned long frame) {
+    while (script->next < script->count && script->events[script->next].frame <= frame) {
+        const struct chip8_input_event* event = &script->events[script->next];
+        if (event->down) {
+            chip8_keyboard_down(keyboard, event->key);
+        } else {
+            chip8_keyboard_up(keyboard, event->key);
+        }
+        script->next += 1;
+    }
+}
@@ -0,0 +1,142 @@
+#include "chip8job.h"
+#include "chip8pack.h"
+#include "chip8rom.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Empty ROMs are rejected along with the ones that do not fit in memory. Only XO-CHIP jobs get room for 64 KB of memory.
+static int chip8_job_load_rom(struct chip8_job* job, const char* data, size_t size, unsigned char quirks) {
+    job->chip8 = chip8_new(quirks & CHIP8_QUIRK_XO_CHIP ? CHIP8_XO_MEMORY_SIZE : CHIP8_MEMORY_SIZE);
+    if (!job->chip8) {
+        return -1;
+    }
+    chip8_set_quirks(job->chip8, quirks);
+    return size > 0 && chip8_load(job->chip8, data, size) == 0 ? 0 : -1;
+}
+
+int chip8_jobs_load(const char* filename, struct chip8_job** jobs, size_t* count) {
+    *jobs = NULL;
+    *count = 0;
+
+    FILE* f = fopen(filename, "r");
+    if (!f) {
+        return -1;
+    }
+
+    // Job files usually list the same ROM many times in a row, all of them are loaded from one mapping
+    struct chip8_rom image = { 0 };
+    char image_name[512] = "";
+
+    // A ROM named <pack>:<name> is loaded from a pack, with the quirks stored for it. The pack stays open for the
+    // jobs that follow.
+    struct chip8_pack pack = { 0 };
+    char pack_name[512] = "";
+
+    size_t capacity = 0;
+    char line[1024];
+    while (fgets(line, sizeof(line), f)) {
+        char rom[512];
+        char input[512] = "-";
+        unsigned long frames;
+        unsigned long cycles = 0;
+
+        if (line[0] == '#' || sscanf(line, "%511s %lu %lu %511s", rom, &frames, &cycles, input) < 2) {
+            continue;
+        }
+
+        if (*count == capacity) {
+            capacity = capacity ? capacity * 2 : 16;
+            struct chip8_job* more = realloc(*jobs, capacity * sizeof(struct chip8_job));
+            if (!more) {
+                goto fail;
+            }
+            *jobs = more;
+        }
+
+        struct chip8_job* job = &(*jobs)[*count];
+        memset(job, 0, sizeof(struct chip8_job));
+        job->max_frames = frames;
+        job->max_cycles = cycles;
+        job->done = frames == 0;
+        job->rom = malloc(strlen(rom) + 1);
+        if (!job->rom) {
+            goto fail;
+        }
+        strcpy(job->rom, rom);
+        *count += 1;
+
+        const char* colon = strrchr(rom, ':');
+        size_t prefix = colon ? (size_t) (colon - rom) : 0;
+        if (colon && (strlen(pack_name) != prefix || strncmp(rom, pack_name, prefix) != 0)) {
+            chip8_pack_close(&pack);
+            snprintf(pack_name, sizeof(pack_name), "%.*s", (int) prefix, rom);
+            if (chip8_pack_open(&pack, pack_name) != 0) {
+                pack_name[0] = '\0'; // Not a pack, but a file name with a colon in it
+            }
+        }
+
+        int res;
+        if (colon && pack_name[0]) {
+            struct chip8_pack_rom packed;
+            res = chip8_pack_find_name(&pack, colon + 1, &packed) == 0 ?
+                chip8_job_load_rom(job, packed.data, packed.size, packed.quirks) : -1;
+        } else {
+            if (strcmp(rom, image_name) != 0) {
+                chip8_rom_close(&image);
+                image_name[0] = '\0';
+                if (chip8_rom_open(&image, rom) != 0) {
+                    fprintf(stderr, "Failed to open ROM %s\n", rom);
+                    goto fail;
+                }
+                strcpy(image_name, rom);
+            }
+            res = chip8_job_load_rom(job, image.data, image.size, chip8_quirk_profile_find("default")->quirks);
+        }
+
+        if (res != 0) {
+            fprintf(stderr, "Failed to load ROM %s\n", rom);
+            goto fail;
+        }
+
+        if (strcmp(input, "-") != 0 && chip8_input_script_load(&job->input, input) != 0) {
+            fprintf(stderr, "Failed to load input script %s\n", input);
+            goto fail;
+        }
+    }
+
+    fclose(f);
+    chip8_rom_close(&image);
+    chip8_pack_close(&pack);
+    return 0;
+
+fail:
+    fclose(f);
+    chip8_rom_close(&image);
+    chip8_pack_close(&pack);
+    chip8_jobs_free(*jobs, *count);
+    *jobs = NULL;
+    *count = 0;
+    return -1;
+}
+
+void chip8_jobs_free(struct chip8_job* jobs, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        free(jobs[i].rom);
+        free(jobs[i].chip8);
+        chip8_input_script_free(&jobs[i].input);
+    }
+    free(jobs);
+}
+
+bool chip8_job_run(struct chip8_job* job, unsigned long frames) {
+    for (unsigned long i = 0; i < frames && !job->done; i++) {
+        chip8_input_script_apply(&job->input, &job->chip8->keyboard, job->frame);
+        chip8_run_frame(job->chip8);
+        job->frame += 1;
+
+        job->done = job->frame >= job->max_frames || (job->max_cycles && job->chip8->cycles >= job->max_cycles);
+    }
+
+    return job->done;
+}
@@ -0,0 +1,254 @@
+#include "chip8lockstep.h"
+#include "config.h"
+#include <stdlib.h>
+#include <string.h>
+
+bool chip8_lockstep_compare(const struct chip8* a, const struct chip8* b, char* what, size_t what_size) {
+    // Registers are compared field by field, since comparing the raw structs would also compare their padding
+    for (int i = 0; i < CHIP8_TOTAL_DATA_REGISTERS; i++) {
+        if (a->registers.V[i] != b->registers.V[i]) {
+            snprintf(what, what_size, "V[%x]", i);
+            return false;
+        }
+    }
+
+    if (a->registers.I != b->registers.I) {
+        snprintf(what, what_size, "I");
+        return false;
+    }
+
+    if (a->registers.PC != b->registers.PC) {
+        snprintf(what, what_size, "PC");
+        return false;
+    }
+
+    if (a->registers.SP != b->registers.SP) {
+        snprintf(what, what_size, "SP");
+        return false;
+    }
+
+    if (a->registers.delay_timer != b->registers.delay_timer) {
+        snprintf(what, what_size, "delay_timer");
+        return false;
+    }
+
+    if (a->registers.sound_timer != b->registers.sound_timer) {
+        snprintf(what, what_size, "sound_timer");
+        return false;
+    }
+
+    for (int i = 0; i < CHIP8_TOTAL_STACK_DEPTH; i++) {
+        if (a->stack.stack[i] != b->stack.stack[i]) {
+            snprintf(what, what_size, "stack[%d]", i);
+            return false;
+        }
+    }
+
+    if (a->memory.mask != b->memory.mask) {
+        snprintf(what, what_size, "memory size");
+        return false;
+    }
+
+    if (memcmp(a->memory.memory, b->memory.memory, chip8_memory_size(&a->memory)) != 0) {
+        for (size_t i = 0; i < chip8_memory_size(&a->memory); i++) {
+            if (a->memory.memory[i] != b->memory.memory[i]) {
+                snprintf(what, what_size, "memory[0x%03zx]", i);
+                return false;
+            }
+        }
+    }
+
+    if (a->screen.hires != b->screen.hires) {
+        snprintf(what, what_size, "screen resolution");
+        return false;
+    }
+
+    for (int y = 0; y < chip8_screen_height(&a->screen); y++) {
+        for (int x = 0; x < chip8_screen_width(&a->screen); x++) {
+            if (chip8_screen_get(&a->screen, x, y) != chip8_screen_get(&b->screen, x, y)) {
+                snprintf(what, what_size, "screen pixel (%d, %d)", x, y);
+                return false;
+            }
+        }
+    }
+
+    if (a->screen.plane_mask != b->screen.plane_mask) {
+        snprintf(what, what_size, "selected planes");
+        return false;
+    }
+
+    for (int i = 0; i < CHIP8_TOTAL_RPL_FLAGS; i++) {
+        if (a->flags[i] != b->flags[i]) {
+            snprintf(what, what_size, "flags[%d]", i);
+            return false;
+        }
+    }
+
+    if (memcmp(a->audio_pattern, b->audio_pattern, CHIP8_AUDIO_PATTERN_SIZE) != 0 || a->pitch != b->pitch) {
+        snprintf(what, what_size, "audio");
+        return false;
+    }
+
+    for (int i = 0; i < CHIP8_TOTAL_KEYS; i++) {
+        if (a->keyboard.keyboard[i] != b->keyboard.keyboard[i]) {
+            snprintf(what, what_size, "key %x", i);
+            return false;
+        }
+    }
+
+    if (a->rng != b->rng) {
+        snprintf(what, what_size, "rng");
+        return false;
+    }
+
+    if (a->cycles != b->cycles) {
+        snprintf(what, what_size, "cycles");
+        return false;
+    }
+
+    if (a->trap != b->trap) {
+        snprintf(what, what_size, "trap");
+        return false;
+    }
+
+    return true;
+}
+
+static void chip8_lockstep_trace_add(struct chip8_lockstep_result* result, const struct chip8* chip8) {
+    struct chip8_lockstep_trace* entry;
+    if (result->trace_count < CHIP8_LOCKSTEP_TRACE_LENGTH) {
+        entry = &result->trace[(result->trace_start + result->trace_count) % CHIP8_LOCKSTEP_TRACE_LENGTH];
+        result->trace_count += 1;
+    } else {
+        // Trace is full, overwrite the oldest entry
+        entry = &result->trace[result->trace_start];
+        result->trace_start = (result->trace_start + 1) % CHIP8_LOCKSTEP_TRACE_LENGTH;
+    }
+
+    unsigned short pc = chip8->registers.PC;
+    entry->cycle = chip8->cycles;
+    entry->PC = pc;
+    entry->opcode = (size_t) pc + 1 < chip8_memory_size(&chip8->memory) ? chip8->memory.memory[pc] << 8 | chip8->memory.memory[pc + 1] : 0;
+}
+
+// Runs one block on both engines and compares them. Returns true if they diverged.
+static bool chip8_lockstep_block(const struct chip8_engine* a, const struct chip8_engine* b, int cycles, struct chip8_lockstep_result* result) {
+    int ran = a->run(result->a, cycles, a->context);
+    if (ran <= 0) {
+        snprintf(result->what, sizeof(result->what), "engine a made no progress");
+        return true;
+    }
+
+    if (b->run(result->b, ran, b->context) != ran) {
+        snprintf(result->what, sizeof(result->what), "number of instructions executed");
+        return true;
+    }
+
+    return !chip8_lockstep_compare(result->a, result->b, result->what, sizeof(result->what));
+}
+
+int chip8_lockstep_run(const struct chip8* initial, const struct chip8_engine* a, const struct chip8_engine* b,
+    struct chip8_input_script* input, unsigned long frames, int block, struct chip8_lockstep_result* result) {
+    memset(result, 0, sizeof(struct chip8_lockstep_result));
+
+    // Both engines and the states they start the current block from, so a diverging block can be replayed
+    size_t stride = (chip8_size(initial) + _Alignof(struct chip8) - 1) / _Alignof(struct chip8) * _Alignof(struct chip8);
+    result->states = malloc(4 * stride);
+    if (!result->states) {
+        return -1;
+    }
+    result->a = (struct chip8*) result->states;
+    result->b = (struct chip8*) (result->states + stride);
+    struct chip8* a_before = (struct chip8*) (result->states + 2 * stride);
+    struct chip8* b_before = (struct chip8*) (result->states + 3 * stride);
+    chip8_copy(result->a, initial);
+    chip8_copy(result->b, initial);
+
+    if (block < 1) {
+        block = 1;
+    }
+
+    if (input) {
+        chip8_input_script_rewind(input);
+    }
+
+    for (unsigned long frame = 0; frame < frames; frame++) {
+        result->frame = frame;
+
+        // Both engines must see the same keys, so the script is applied once and the keyboard copied over
+        if (input) {
+            chip8_input_script_apply(input, &result->a->keyboard, frame);
+            memcpy(result->b->keyboard.keyboard, result->a->keyboard.keyboard, sizeof(result->b->keyboard.keyboard));
+        }
+
+        int remaining = CHIP8_CYCLES_PER_FRAME;
+        while (remaining > 0) {
+            int cycles = remaining < block ? remaining : block;
+            chip8_copy(a_before, result->a);
+            chip8_copy(b_before, result->b);
+            chip8_lockstep_trace_add(result, result->a);
+
+            if (!chip8_lockstep_block(a, b, cycles, result)) {
+                remaining -= result->a->cycles - a_before->cycles;
+                continue;
+            }
+
+            // Narrow the divergence down to a single instruction by replaying the block one step at a time
+            if (cycles > 1) {
+                chip8_copy(result->a, a_before);
+                chip8_copy(result->b, b_before);
+                result->trace_count -= 1;
+                for (int i = 0; i < cycles; i++) {
+                    chip8_lockstep_trace_add(result, result->a);
+                    if (chip8_lockstep_block(a, b, 1, result)) {
+                        break;
+                    }
+                }
+            }
+
+            result->diverged = true;
+            return 1;
+        }
+
+        chip8_tick_timers(result->a);
+        chip8_tick_timers(result->b);
+    }
+
+    return 0;
+}
+
+void chip8_lockstep_free(struct chip8_lockstep_result* result) {
+    free(result->states);
+    result->states = NULL;
+    result->a = NULL;
+    result->b = NULL;
+}
+
+static void chip8_lockstep_report_state(const char* name, const struct chip8* chip8, FILE* out) {
+    fprintf(out, "  %-10s PC=%03x I=%03x SP=%x DT=%02x ST=%02x V=", name, chip8->registers.PC, chip8->registers.I,
+        chip8->registers.SP, chip8->registers.delay_timer, chip8->registers.sound_timer);
+    for (int i = 0; i < CHIP8_TOTAL_DATA_REGISTERS; i++) {
+        fprintf(out, "%02x", chip8->registers.V[i]);
+        fputc(i == CHIP8_TOTAL_DATA_REGISTERS - 1 ? '\n' : ' ', out);
+    }
+}
+
+void chip8_lockstep_report(const struct chip8_lockstep_result* result, const struct chip8_engine* a, const struct chip8_engine* b, FILE* out) {
+    if (!result->diverged) {
+        fprintf(out, "%s and %s agree after %lu frames (%lu instructions)\n", a->name, b->name, result->frame + 1, result->a->cycles);
+        return;
+    }
+
+    fprintf(out, "%s and %s diverged in frame %lu at instruction %lu: %s differs\n", a->name, b->name, result->frame,
+        result->a->cycles, result->what);
+
+    fprintf(out, "Trace (Last %d instructions, diverging one last):\n", result->trace_count);
+    for (int i = 0; i < result->trace_count; i++) {
+        const struct chip8_lockstep_trace* entry = &result->trace[(result->trace_start + i) % CHIP8_LOCKSTEP_TRACE_LENGTH];
+        fprintf(out, "  %8lu  %03x: %04x\n", entry->cycle, entry->PC, entry->opcode);
+    }
+
+    fprintf(out, "State after the diverging instruction:\n");
+    chip8_lockstep_report_state(a->name, result->a, out);
+    chip8_lockstep_report_state(b->name, result->b, out);
+}
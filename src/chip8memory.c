@@ -1,30 +1,37 @@
 #include "chip8memory.h"
+#include "chip8.h"
 #include <assert.h>
 
-static void chip8_is_memory_in_bounds(int index) {
-    assert(index >= 0 && index < CHIP8_MEMORY_SIZE);
+// Returns the address actually accessed: The index masked into the addressable memory, raising a trap if it was out
+// of range. Neither needs a branch, and release builds (NDEBUG) have no assert either.
+static unsigned int chip8_memory_address(struct chip8* chip8, int index) {
+    unsigned int mask = chip8->memory.mask;
+    assert(index >= 0 && (unsigned int) index <= mask);
+
+    chip8->trap |= ((unsigned int) index & ~mask) ? CHIP8_TRAP_MEMORY : 0;
+    return (unsigned int) index & mask;
 }
 
-void chip8_memory_set(struct chip8_memory* memory, int index, unsigned char val) {
-    chip8_is_memory_in_bounds(index);
+size_t chip8_memory_size(const struct chip8_memory* memory) {
+    return (size_t) memory->mask + 1;
+}
 
+void chip8_memory_set(struct chip8* chip8, int index, unsigned char val) {
     // Setting memory
-    memory->memory[index] = val;
+    chip8->memory.memory[chip8_memory_address(chip8, index)] = val;
 }
 
-unsigned char chip8_memory_get(struct chip8_memory* memory, int index) {
-    chip8_is_memory_in_bounds(index);
-    
+unsigned char chip8_memory_get(struct chip8* chip8, int index) {
     // Getting memory
-    return memory->memory[index];
+    return chip8->memory.memory[chip8_memory_address(chip8, index)];
 }
 
-unsigned short chip8_memory_get_short(struct chip8_memory* memory, int index) {
+unsigned short chip8_memory_get_short(struct chip8* chip8, int index) {
     // Getting each byte of memory
-    unsigned char byte1 = chip8_memory_get(memory, index);
-    unsigned char byte2 = chip8_memory_get(memory, index + 1);
+    unsigned char byte1 = chip8_memory_get(chip8, index);
+    unsigned char byte2 = chip8_memory_get(chip8, index + 1);
 
     // Merging these 2 unsigned chars together, thus making it an unsigned short, since it's now 2 bytes.
     // This allows us to read 2 bytes of memory.
     return byte1 << 8 | byte2;
-}
\ No newline at end of file
+}
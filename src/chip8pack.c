@@ -0,0 +1,222 @@
+#include "chip8pack.h"
+#include "chip8endian.h"
+#include "chip8hash.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const unsigned char chip8_pack_magic[4] = { 'C', '8', 'P', 'K' };
+
+static const unsigned char* chip8_pack_base(const struct chip8_pack* pack) {
+    return (const unsigned char*) pack->file.data;
+}
+
+// Index tables come right after the entries, the content index first
+static const unsigned char* chip8_pack_index(const struct chip8_pack* pack, int table) {
+    return chip8_pack_base(pack) + CHIP8_PACK_HEADER_SIZE + pack->count * CHIP8_PACK_ENTRY_SIZE + table * pack->buckets * 4;
+}
+
+int chip8_pack_open(struct chip8_pack* pack, const char* filename) {
+    memset(pack, 0, sizeof(struct chip8_pack));
+    if (chip8_rom_open(&pack->file, filename) != 0) {
+        return -1;
+    }
+
+    const unsigned char* p = chip8_pack_base(pack);
+    if (pack->file.size < CHIP8_PACK_HEADER_SIZE || memcmp(p, chip8_pack_magic, sizeof(chip8_pack_magic)) != 0 ||
+        chip8_get16(p + 4) != CHIP8_PACK_VERSION) {
+        goto fail;
+    }
+
+    pack->count = chip8_get32(p + 8);
+    pack->buckets = chip8_get32(p + 12);
+
+    // Lookups stop at the first empty bucket, so there must be at least one
+    if (pack->buckets <= pack->count || (pack->buckets & (pack->buckets - 1)) != 0) {
+        goto fail;
+    }
+
+    if (CHIP8_PACK_HEADER_SIZE + pack->count * CHIP8_PACK_ENTRY_SIZE + 2 * pack->buckets * 4 > pack->file.size) {
+        goto fail;
+    }
+
+    return 0;
+
+fail:
+    chip8_pack_close(pack);
+    return -1;
+}
+
+void chip8_pack_close(struct chip8_pack* pack) {
+    chip8_rom_close(&pack->file);
+    memset(pack, 0, sizeof(struct chip8_pack));
+}
+
+int chip8_pack_get(const struct chip8_pack* pack, size_t index, struct chip8_pack_rom* rom) {
+    if (index >= pack->count) {
+        return -1;
+    }
+
+    const unsigned char* base = chip8_pack_base(pack);
+    const unsigned char* e = base + CHIP8_PACK_HEADER_SIZE + index * CHIP8_PACK_ENTRY_SIZE;
+    size_t data_offset = chip8_get32(e + 16);
+    size_t data_size = chip8_get32(e + 20);
+    size_t name_offset = chip8_get32(e + 24);
+    size_t name_length = chip8_get16(e + 28);
+
+    // Everything must lie within the file, and the name must be terminated where the entry says
+    if (data_offset + data_size > pack->file.size || name_offset + name_length >= pack->file.size ||
+        base[name_offset + name_length] != '\0') {
+        return -1;
+    }
+
+    rom->name = (const char*) base + name_offset;
+    rom->data = (const char*) base + data_offset;
+    rom->size = data_size;
+    rom->hash = chip8_get64(e);
+    rom->quirks = e[30];
+    rom->ips = chip8_get16(e + 32);
+    memcpy(rom->keys, e + 34, CHIP8_TOTAL_KEYS);
+    return 0;
+}
+
+// Probes one of the index tables (0 = content, 1 = names) for hash. With a name, entries whose hash matches must also
+// have that name, since hashes of different names can collide.
+static int chip8_pack_find(const struct chip8_pack* pack, int table, uint64_t hash, const char* name, struct chip8_pack_rom* rom) {
+    const unsigned char* index = chip8_pack_index(pack, table);
+    size_t mask = pack->buckets - 1;
+
+    for (size_t probe = 0; probe < pack->buckets; probe++) {
+        uint32_t slot = chip8_get32(index + ((hash + probe) & mask) * 4);
+        if (slot == 0 || slot > pack->count) {
+            return -1;
+        }
+
+        const unsigned char* e = chip8_pack_base(pack) + CHIP8_PACK_HEADER_SIZE + (slot - 1) * CHIP8_PACK_ENTRY_SIZE;
+        if (chip8_get64(e + table * 8) != hash) {
+            continue;
+        }
+
+        if (chip8_pack_get(pack, slot - 1, rom) != 0) {
+            return -1;
+        }
+
+        if (!name || strcmp(rom->name, name) == 0) {
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+int chip8_pack_find_name(const struct chip8_pack* pack, const char* name, struct chip8_pack_rom* rom) {
+    return chip8_pack_find(pack, 1, chip8_hash(name, strlen(name), 0), name, rom);
+}
+
+int chip8_pack_find_hash(const struct chip8_pack* pack, uint64_t hash, struct chip8_pack_rom* rom) {
+    return chip8_pack_find(pack, 0, hash, NULL, rom);
+}
+
+// Inserts entry number + 1 into an index table at the first free bucket from hash
+static void chip8_pack_insert(unsigned char* index, size_t buckets, uint64_t hash, size_t entry) {
+    size_t b = hash & (buckets - 1);
+    while (chip8_get32(index + b * 4) != 0) {
+        b = (b + 1) & (buckets - 1);
+    }
+    chip8_put32(index + b * 4, entry + 1);
+}
+
+int chip8_pack_write(const char* filename, const struct chip8_pack_rom* roms, size_t count) {
+    // At most half full, so probes stay short and there is always an empty bucket to stop lookups
+    size_t buckets = 1;
+    while (buckets < 2 * count) {
+        buckets *= 2;
+    }
+
+    // Layout: Names follow the index, ROM data follows the names
+    size_t names_offset = CHIP8_PACK_HEADER_SIZE + count * CHIP8_PACK_ENTRY_SIZE + 2 * buckets * 4;
+    size_t size = names_offset;
+    for (size_t i = 0; i < count; i++) {
+        if (strlen(roms[i].name) > 0xffff || roms[i].ips > 0xffff) {
+            return -1;
+        }
+        size += strlen(roms[i].name) + 1 + roms[i].size;
+    }
+    if (size > UINT32_MAX) {
+        return -1;
+    }
+
+    unsigned char* buf = calloc(size, 1);
+    uint64_t* hashes = malloc((count ? count : 1) * sizeof(uint64_t));
+    size_t* offsets = malloc((count ? count : 1) * sizeof(size_t));
+    if (!buf || !hashes || !offsets) {
+        free(buf);
+        free(hashes);
+        free(offsets);
+        return -1;
+    }
+
+    memcpy(buf, chip8_pack_magic, sizeof(chip8_pack_magic));
+    chip8_put16(buf + 4, CHIP8_PACK_VERSION);
+    chip8_put32(buf + 8, count);
+    chip8_put32(buf + 12, buckets);
+
+    size_t name_end = names_offset;
+    for (size_t i = 0; i < count; i++) {
+        name_end += strlen(roms[i].name) + 1;
+    }
+
+    size_t name_at = names_offset;
+    size_t data_at = name_end;
+    for (size_t i = 0; i < count; i++) {
+        const struct chip8_pack_rom* rom = &roms[i];
+        size_t name_length = strlen(rom->name);
+        hashes[i] = chip8_hash(rom->data, rom->size, 0);
+
+        // A ROM already in the pack under another name shares its data
+        offsets[i] = data_at;
+        for (size_t j = 0; j < i; j++) {
+            if (hashes[j] == hashes[i] && roms[j].size == rom->size && memcmp(roms[j].data, rom->data, rom->size) == 0) {
+                offsets[i] = offsets[j];
+                break;
+            }
+        }
+        if (offsets[i] == data_at) {
+            memcpy(buf + data_at, rom->data, rom->size);
+            data_at += rom->size;
+        }
+
+        memcpy(buf + name_at, rom->name, name_length + 1);
+
+        unsigned char* e = buf + CHIP8_PACK_HEADER_SIZE + i * CHIP8_PACK_ENTRY_SIZE;
+        chip8_put64(e, hashes[i]);
+        chip8_put64(e + 8, chip8_hash(rom->name, name_length, 0));
+        chip8_put32(e + 16, offsets[i]);
+        chip8_put32(e + 20, rom->size);
+        chip8_put32(e + 24, name_at);
+        chip8_put16(e + 28, name_length);
+        e[30] = rom->quirks;
+        chip8_put16(e + 32, rom->ips);
+        memcpy(e + 34, rom->keys, CHIP8_TOTAL_KEYS);
+
+        unsigned char* index = buf + CHIP8_PACK_HEADER_SIZE + count * CHIP8_PACK_ENTRY_SIZE;
+        chip8_pack_insert(index, buckets, hashes[i], i);
+        chip8_pack_insert(index + buckets * 4, buckets, chip8_hash(rom->name, name_length, 0), i);
+
+        name_at += name_length + 1;
+    }
+
+    // Shared ROM data leaves the end of the buffer unused
+    size = data_at;
+
+    FILE* f = fopen(filename, "wb");
+    int res = f && fwrite(buf, size, 1, f) == 1 ? 0 : -1;
+    if (f && fclose(f) != 0) {
+        res = -1;
+    }
+
+    free(buf);
+    free(hashes);
+    free(offsets);
+    return res;
+}
@@ -0,0 +1,49 @@
+#include "chip8platform.h"
+
+#ifdef _WIN32
+
+#include <windows.h>
+
+uint64_t chip8_platform_now(void) {
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+
+    // Split in seconds and the rest, so that counter * 10^9 cannot overflow
+    uint64_t seconds = counter.QuadPart / frequency.QuadPart;
+    uint64_t rest = counter.QuadPart % frequency.QuadPart;
+    return seconds * CHIP8_NANOSECONDS_PER_SECOND + rest * CHIP8_NANOSECONDS_PER_SECOND / frequency.QuadPart;
+}
+
+void chip8_platform_sleep_until(uint64_t deadline) {
+    // Sleep only has a granularity of a few milliseconds, so it is used for all but the last millisecond,
+    // which is waited out by giving up the rest of the time slice until the deadline
+    for (uint64_t now = chip8_platform_now(); now < deadline; now = chip8_platform_now()) {
+        DWORD milliseconds = (deadline - now) / 1000000;
+        Sleep(milliseconds > 1 ? milliseconds - 1 : 0);
+    }
+}
+
+#else
+
+#include <errno.h>
+#include <time.h>
+
+uint64_t chip8_platform_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * CHIP8_NANOSECONDS_PER_SECOND + now.tv_nsec;
+}
+
+void chip8_platform_sleep_until(uint64_t deadline) {
+    struct timespec until;
+    until.tv_sec = deadline / CHIP8_NANOSECONDS_PER_SECOND;
+    until.tv_nsec = deadline % CHIP8_NANOSECONDS_PER_SECOND;
+
+    // With TIMER_ABSTIME, a sleep interrupted by a signal is simply restarted with the same deadline
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL) == EINTR) {
+    }
+}
+
+#endif
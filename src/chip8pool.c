@@ -0,0 +1,705 @@
+#include "chip8pool.h"
+#include "chip8.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Shorthands for the state of instance i, so the interpreter below reads like chip8_exec
+#define POOL_V(r) pool->V[(r) * pool->count + i]
+#define POOL_STACK(d) pool->stack[(d) * pool->count + i]
+#define POOL_MEMORY(address) pool->memory[i * CHIP8_POOL_MEMORY_STRIDE + (address)]
+#define POOL_ADDRESS(address) chip8_pool_address(pool, i, address)
+
+#define CHIP8_POOL_TILE 64 // Instances stepped together by chip8_pool_run
+#define CHIP8_POOL_LANES 32 // Instances executed by one vector instruction (One AVX2 register, or two SSE2 registers)
+#define CHIP8_POOL_MIN_LANES 8 // Below this many lanes sharing an opcode, vector execution is not worth it
+#define CHIP8_POOL_GROUP_ROUNDS 4 // Opcodes tried when looking for the largest group of lanes sharing one
+
+// One byte per instance, e.g. register Vx of 32 neighbouring instances. GCC lowers operations on these to AVX2
+// when built with -mavx2 (or -march=native), to SSE2 on any other x86-64 target, and to scalar code elsewhere.
+typedef unsigned char chip8_pool_lanes __attribute__((vector_size(CHIP8_POOL_LANES)));
+
+// Two bytes per instance: I, PC, keys and opcodes
+typedef unsigned short chip8_pool_wide_lanes __attribute__((vector_size(CHIP8_POOL_LANES * 2)));
+
+// Lane masks (All bits set where true) are computed with arithmetic rather than vector comparisons: GCC only has
+// comparisons for vectors the size of a hardware register, and compares wider ones (e.g. 32 bytes on SSE2) one lane
+// at a time. The top bit of t | -t is set exactly when t is not 0, and the top bit of the borrow of a - b (Computed
+// bitwise, as in a subtractor) is set exactly when a < b.
+#define CHIP8_POOL_LANES_EQUAL(a, b) (((((a) ^ (b)) | -((a) ^ (b))) >> 7) - 1)
+#define CHIP8_POOL_LANES_BELOW(a, b) (-(((~(a) & (b)) | (~((a) ^ (b)) & ((a) - (b)))) >> 7))
+#define CHIP8_POOL_WIDE_LANES_EQUAL(a, b) (((((a) ^ (b)) | -((a) ^ (b))) >> 15) - 1)
+
+// Out of range addresses and stack pointers wrap around and raise a trap, like in chip8_memory_get / chip8_stack_push
+static unsigned int chip8_pool_address(struct chip8_pool* pool, size_t i, unsigned int address) {
+    pool->trap[i] |= address >= CHIP8_MEMORY_SIZE ? CHIP8_TRAP_MEMORY : 0;
+    return address & (CHIP8_MEMORY_SIZE - 1);
+}
+
+static unsigned short chip8_pool_stack_slot(struct chip8_pool* pool, size_t i) {
+    pool->trap[i] |= pool->SP[i] >= CHIP8_TOTAL_STACK_DEPTH ? CHIP8_TRAP_STACK : 0;
+    return pool->SP[i] & (CHIP8_TOTAL_STACK_DEPTH - 1);
+}
+
+int chip8_pool_init(struct chip8_pool* pool, size_t count) {
+    memset(pool, 0, sizeof(struct chip8_pool));
+    pool->count = count;
+
+    pool->V = calloc(count * CHIP8_TOTAL_DATA_REGISTERS, sizeof(unsigned char));
+    pool->I = calloc(count, sizeof(unsigned short));
+    pool->PC = calloc(count, sizeof(unsigned short));
+    pool->SP = calloc(count, sizeof(unsigned short));
+    pool->delay_timer = calloc(count, sizeof(unsigned char));
+    pool->sound_timer = calloc(count, sizeof(unsigned char));
+    pool->stack = calloc(count * CHIP8_TOTAL_STACK_DEPTH, sizeof(unsigned short));
+    pool->keys = calloc(count, sizeof(unsigned short));
+    pool->rng = calloc(count, sizeof(unsigned int));
+    pool->cycles = calloc(count, sizeof(unsigned long));
+    pool->trap = calloc(count, sizeof(unsigned char));
+    pool->screen = calloc(count * CHIP8_HEIGHT, sizeof(uint64_t));
+    pool->memory = calloc(count, CHIP8_POOL_MEMORY_STRIDE);
+
+    if (!pool->V || !pool->I || !pool->PC || !pool->SP || !pool->delay_timer || !pool->sound_timer || !pool->stack ||
+        !pool->keys || !pool->rng || !pool->cycles || !pool->trap || !pool->screen || !pool->memory) {
+        chip8_pool_free(pool);
+        return -1;
+    }
+
+    struct chip8* chip8 = chip8_new(CHIP8_MEMORY_SIZE);
+    if (!chip8) {
+        chip8_pool_free(pool);
+        return -1;
+    }
+    for (size_t i = 0; i < count; i++) {
+        chip8_pool_set(pool, i, chip8);
+    }
+    free(chip8);
+
+    return 0;
+}
+
+void chip8_pool_free(struct chip8_pool* pool) {
+    free(pool->V);
+    free(pool->I);
+    free(pool->PC);
+    free(pool->SP);
+    free(pool->delay_timer);
+    free(pool->sound_timer);
+    free(pool->stack);
+    free(pool->keys);
+    free(pool->rng);
+    free(pool->cycles);
+    free(pool->trap);
+    free(pool->screen);
+    free(pool->memory);
+    memset(pool, 0, sizeof(struct chip8_pool));
+}
+
+int chip8_pool_set(struct chip8_pool* pool, size_t i, const struct chip8* chip8) {
+    if (chip8->quirks != 0 || chip8->screen.hires) {
+        return -1;
+    }
+
+    for (int r = 0; r < CHIP8_TOTAL_DATA_REGISTERS; r++) {
+        POOL_V(r) = chip8->registers.V[r];
+    }
+    pool->I[i] = chip8->registers.I;
+    pool->PC[i] = chip8->registers.PC;
+    pool->SP[i] = chip8->registers.SP;
+    pool->delay_timer[i] = chip8->registers.delay_timer;
+    pool->sound_timer[i] = chip8->registers.sound_timer;
+
+    for (int d = 0; d < CHIP8_TOTAL_STACK_DEPTH; d++) {
+        POOL_STACK(d) = chip8->stack.stack[d];
+    }
+
+    unsigned short keys = 0;
+    for (int k = 0; k < CHIP8_TOTAL_KEYS; k++) {
+        keys |= chip8->keyboard.keyboard[k] << k;
+    }
+    pool->keys[i] = keys;
+
+    pool->rng[i] = chip8->rng;
+    pool->cycles[i] = chip8->cycles;
+    pool->trap[i] = chip8->trap;
+
+    // Same layout as the low resolution rows of struct chip8_screen
+    for (int y = 0; y < CHIP8_HEIGHT; y++) {
+        pool->screen[i * CHIP8_HEIGHT + y] = chip8->screen.planes[0][y][0];
+    }
+
+    memcpy(&POOL_MEMORY(0), chip8->memory.memory, CHIP8_MEMORY_SIZE);
+    return 0;
+}
+
+void chip8_pool_get(const struct chip8_pool* pool, size_t i, struct chip8* chip8) {
+    for (int r = 0; r < CHIP8_TOTAL_DATA_REGISTERS; r++) {
+        chip8->registers.V[r] = POOL_V(r);
+    }
+    chip8->registers.I = pool->I[i];
+    chip8->registers.PC = pool->PC[i];
+    chip8->registers.SP = pool->SP[i];
+    chip8->registers.delay_timer = pool->delay_timer[i];
+    chip8->registers.sound_timer = pool->sound_timer[i];
+
+    for (int d = 0; d < CHIP8_TOTAL_STACK_DEPTH; d++) {
+        chip8->stack.stack[d] = POOL_STACK(d);
+    }
+
+    for (int k = 0; k < CHIP8_TOTAL_KEYS; k++) {
+        chip8->keyboard.keyboard[k] = (pool->keys[i] >> k) & 1;
+    }
+
+    chip8->rng = pool->rng[i];
+    chip8->cycles = pool->cycles[i];
+    chip8->trap = pool->trap[i];
+
+    chip8_screen_set_hires(&chip8->screen, false);
+    for (int y = 0; y < CHIP8_HEIGHT; y++) {
+        chip8->screen.planes[0][y][0] = pool->screen[i * CHIP8_HEIGHT + y];
+    }
+
+    memcpy(chip8->memory.memory, &POOL_MEMORY(0), CHIP8_MEMORY_SIZE);
+}
+
+// Same generator as chip8_random
+static unsigned char chip8_pool_random(struct chip8_pool* pool, size_t i) {
+    unsigned int r = pool->rng[i];
+    r ^= r << 13;
+    r ^= r >> 17;
+    r ^= r << 5;
+    pool->rng[i] = r;
+    return r >> 24;
+}
+
+// Draws a sprite with the same wrapping as chip8_screen_draw_sprite, but a whole sprite row at once:
+// The byte is placed at the left of a 64-bit word, then rotated right by x so pixels past the right edge wrap around.
+static bool chip8_pool_draw_sprite(struct chip8_pool* pool, size_t i, int x, int y, unsigned short address, int num) {
+    uint64_t* screen = &pool->screen[i * CHIP8_HEIGHT];
+    uint64_t collision = 0;
+    int shift = x % CHIP8_WIDTH;
+    pool->trap[i] |= address >= CHIP8_MEMORY_SIZE ? CHIP8_TRAP_MEMORY : 0;
+
+    for (int ly = 0; ly < num; ly++) {
+        uint64_t bits = (uint64_t) POOL_MEMORY((address + ly) % CHIP8_MEMORY_SIZE) << 56;
+        if (shift) {
+            bits = bits >> shift | bits << (64 - shift);
+        }
+        uint64_t* row = &screen[(ly + y) % CHIP8_HEIGHT];
+        collision |= *row & bits;
+        *row ^= bits;
+    }
+
+    return collision != 0;
+}
+
+// Instruction semantics must match chip8_exec exactly (Including the order registers are written in when x = F),
+// the lockstep runner checks this through the "pool" engine.
+static void chip8_pool_exec(struct chip8_pool* pool, size_t i, unsigned short opcode) {
+    unsigned short nnn = opcode & 0x0fff;
+    unsigned char x = (opcode >> 8) & 0x000f;
+    unsigned char y = (opcode >> 4) & 0x000f;
+    unsigned char kk = opcode & 0x00ff;
+    unsigned char n = opcode & 0x000f;
+    unsigned short tmp;
+
+    switch (opcode & 0xf000) {
+        case 0x0000:
+            if (opcode == 0x00E0) {
+                memset(&pool->screen[i * CHIP8_HEIGHT], 0, CHIP8_HEIGHT * sizeof(uint64_t));
+            } else if (opcode == 0x00EE) {
+                pool->SP[i] -= 1;
+                pool->PC[i] = POOL_STACK(chip8_pool_stack_slot(pool, i));
+            }
+        break;
+
+        case 0x1000:
+            pool->PC[i] = nnn;
+        break;
+
+        case 0x2000:
+            POOL_STACK(chip8_pool_stack_slot(pool, i)) = pool->PC[i];
+            pool->SP[i] += 1;
+            pool->PC[i] = nnn;
+        break;
+
+        case 0x3000:
+            if (POOL_V(x) == kk) {
+                pool->PC[i] += 2;
+            }
+        break;
+
+        case 0x4000:
+            if (POOL_V(x) != kk) {
+                pool->PC[i] += 2;
+            }
+        break;
+
+        case 0x5000:
+            if (POOL_V(x) == POOL_V(y)) {
+                pool->PC[i] += 2;
+            }
+        break;
+
+        case 0x6000:
+            POOL_V(x) = kk;
+        break;
+
+        case 0x7000:
+            POOL_V(x) += kk;
+        break;
+
+        case 0x8000:
+            switch (n) {
+                case 0x00:
+                    POOL_V(x) = POOL_V(y);
+                break;
+
+                case 0x01:
+                    POOL_V(x) |= POOL_V(y);
+                break;
+
+                case 0x02:
+                    POOL_V(x) &= POOL_V(y);
+                break;
+
+                case 0x03:
+                    POOL_V(x) ^= POOL_V(y);
+                break;
+
+                case 0x04:
+                    tmp = POOL_V(x) + POOL_V(y);
+                    POOL_V(0x0f) = tmp > 0xff;
+                    POOL_V(x) = tmp;
+                break;
+
+                case 0x05:
+                    POOL_V(0x0f) = 0; // chip8_exec compares Vx with itself here
+                    POOL_V(x) = POOL_V(x) - POOL_V(y);
+                break;
+
+                case 0x06:
+                    POOL_V(0x0f) = POOL_V(x) & 0x01;
+                    POOL_V(x) /= 2;
+                break;
+
+                case 0x07:
+                    POOL_V(0x0f) = POOL_V(y) > POOL_V(x);
+                    POOL_V(x) = POOL_V(y) - POOL_V(x);
+                break;
+
+                case 0x0E:
+                    POOL_V(0x0f) = POOL_V(x) & 0x80;
+                    POOL_V(x) *= 2;
+                break;
+            }
+        break;
+
+        case 0x9000:
+            if (POOL_V(x) != POOL_V(y)) {
+                pool->PC[i] += 2;
+            }
+        break;
+
+        case 0xA000:
+            pool->I[i] = nnn;
+        break;
+
+        case 0xB000:
+            pool->PC[i] = nnn + POOL_V(0);
+        break;
+
+        case 0xC000:
+            POOL_V(x) = chip8_pool_random(pool, i) & kk;
+        break;
+
+        case 0xD000:
+            POOL_V(0x0f) = chip8_pool_draw_sprite(pool, i, POOL_V(x), POOL_V(y), pool->I[i], n);
+        break;
+
+        case 0xE000:
+            if (kk == 0x9E && POOL_V(x) < CHIP8_TOTAL_KEYS && (pool->keys[i] >> POOL_V(x)) & 1) {
+                pool->PC[i] += 2;
+            } else if (kk == 0xA1 && !(POOL_V(x) < CHIP8_TOTAL_KEYS && (pool->keys[i] >> POOL_V(x)) & 1)) {
+                pool->PC[i] += 2;
+            }
+        break;
+
+        case 0xF000:
+            switch (kk) {
+                case 0x07:
+                    POOL_V(x) = pool->delay_timer[i];
+                break;
+
+                case 0x0A:
+                    if (pool->keys[i] == 0) {
+                        pool->PC[i] -= 2;
+                        break;
+                    }
+                    POOL_V(x) = __builtin_ctz(pool->keys[i]); // Lowest key that is down, like chip8_wait_for_key_press
+                break;
+
+                case 0x15:
+                    pool->delay_timer[i] = POOL_V(x);
+                break;
+
+                case 0x18:
+                    pool->sound_timer[i] = POOL_V(x);
+                break;
+
+                case 0x1E:
+                    pool->I[i] += POOL_V(x);
+                break;
+
+                case 0x29:
+                    pool->I[i] = POOL_V(x) * CHIP8_DEFAULT_SPRITE_HEIGHT;
+                break;
+
+                // Like chip8_exec, Fx33 carries on into Fx55
+                case 0x33:
+                    POOL_MEMORY(POOL_ADDRESS(pool->I[i])) = POOL_V(x) / 100;
+                    POOL_MEMORY(POOL_ADDRESS(pool->I[i] + 1)) = POOL_V(x) / 10 % 10;
+                    POOL_MEMORY(POOL_ADDRESS(pool->I[i] + 2)) = POOL_V(x) % 10;
+                    // fall through
+                case 0x55:
+                    for (int r = 0; r <= x; r++) {
+                        POOL_MEMORY(POOL_ADDRESS(pool->I[i] + r)) = POOL_V(r);
+                    }
+                break;
+
+                case 0x65:
+                    for (int r = 0; r <= x; r++) {
+                        POOL_V(r) = POOL_MEMORY(POOL_ADDRESS(pool->I[i] + r));
+                    }
+                break;
+            }
+        break;
+    }
+}
+
+// Vectors are moved in and out of the state arrays with memcpy, which compiles to unaligned vector loads/stores.
+// Stores only write the lanes set in mask, the others keep their value.
+#define CHIP8_POOL_LANES_LOAD(v, p) memcpy(&(v), (p), sizeof(v))
+
+#define CHIP8_POOL_LANES_STORE(p, v, mask) do { \
+        __typeof__(v) old; \
+        CHIP8_POOL_LANES_LOAD(old, p); \
+        old = ((v) & (mask)) | (old & ~(mask)); \
+        memcpy((p), &old, sizeof(old)); \
+    } while (0)
+
+// Executes opcode on every lane set in mask, starting at instance start, and moves their PC on. Only the instructions
+// that hot loops spend most of their time in (Register arithmetic, skips, jumps, I, timers and key tests) are
+// vectorized, returns false (Executing nothing) for any other opcode.
+static bool chip8_pool_exec_lanes(struct chip8_pool* pool, size_t start, unsigned short opcode, const chip8_pool_wide_lanes* wide_mask) {
+    unsigned short nnn = opcode & 0x0fff;
+    unsigned char x = (opcode >> 8) & 0x000f;
+    unsigned char y = (opcode >> 4) & 0x000f;
+    unsigned char kk = opcode & 0x00ff;
+    unsigned char* vx = &pool->V[x * pool->count + start];
+    unsigned char* vy = &pool->V[y * pool->count + start];
+    unsigned char* vf = &pool->V[0x0f * pool->count + start];
+    chip8_pool_lanes mask = __builtin_convertvector(*wide_mask, chip8_pool_lanes);
+    chip8_pool_lanes a;
+    chip8_pool_lanes b;
+    CHIP8_POOL_LANES_LOAD(a, vx);
+    CHIP8_POOL_LANES_LOAD(b, vy);
+
+    // PC after the instruction, lanes set in skip also move past the next one
+    chip8_pool_wide_lanes pc;
+    CHIP8_POOL_LANES_LOAD(pc, &pool->PC[start]);
+    pc += 2;
+    chip8_pool_lanes skip = a ^ a;
+
+    switch (opcode & 0xf000) {
+        case 0x1000:
+            pc = (pc ^ pc) + nnn;
+        break;
+
+        case 0x3000:
+            skip = CHIP8_POOL_LANES_EQUAL(a, (a ^ a) + kk);
+        break;
+
+        case 0x4000:
+            skip = ~CHIP8_POOL_LANES_EQUAL(a, (a ^ a) + kk);
+        break;
+
+        case 0x5000:
+            skip = CHIP8_POOL_LANES_EQUAL(a, b);
+        break;
+
+        case 0x6000:
+            CHIP8_POOL_LANES_STORE(vx, (a ^ a) + kk, mask);
+        break;
+
+        case 0x7000:
+            CHIP8_POOL_LANES_STORE(vx, a + kk, mask);
+        break;
+
+        // VF is written before Vx, like chip8_exec. Except for 8xy4, Vx and Vy are read again after it, so the result
+        // is the same when x or y is F.
+        case 0x8000:
+            switch (opcode & 0x000f) {
+                case 0x00:
+                    CHIP8_POOL_LANES_STORE(vx, b, mask);
+                break;
+
+                case 0x01:
+                    CHIP8_POOL_LANES_STORE(vx, a | b, mask);
+                break;
+
+                case 0x02:
+                    CHIP8_POOL_LANES_STORE(vx, a & b, mask);
+                break;
+
+                case 0x03:
+                    CHIP8_POOL_LANES_STORE(vx, a ^ b, mask);
+                break;
+
+                // The sum wrapped around (Carry) exactly when it is smaller than one of the operands
+                case 0x04:
+                {
+                    chip8_pool_lanes sum = a + b;
+                    CHIP8_POOL_LANES_STORE(vf, CHIP8_POOL_LANES_BELOW(sum, a) & 1, mask);
+                    CHIP8_POOL_LANES_STORE(vx, sum, mask);
+                }
+                break;
+
+                case 0x05:
+                    CHIP8_POOL_LANES_STORE(vf, a ^ a, mask); // chip8_exec compares Vx with itself here
+                    CHIP8_POOL_LANES_LOAD(a, vx);
+                    CHIP8_POOL_LANES_LOAD(b, vy);
+                    CHIP8_POOL_LANES_STORE(vx, a - b, mask);
+                break;
+
+                case 0x06:
+                    CHIP8_POOL_LANES_STORE(vf, a & 1, mask);
+                    CHIP8_POOL_LANES_LOAD(a, vx);
+                    CHIP8_POOL_LANES_STORE(vx, a >> 1, mask);
+                break;
+
+                case 0x07:
+                    CHIP8_POOL_LANES_STORE(vf, CHIP8_POOL_LANES_BELOW(a, b) & 1, mask);
+                    CHIP8_POOL_LANES_LOAD(a, vx);
+                    CHIP8_POOL_LANES_LOAD(b, vy);
+                    CHIP8_POOL_LANES_STORE(vx, b - a, mask);
+                break;
+
+                case 0x0E:
+                    CHIP8_POOL_LANES_STORE(vf, a & 0x80, mask);
+                    CHIP8_POOL_LANES_LOAD(a, vx);
+                    CHIP8_POOL_LANES_STORE(vx, a << 1, mask);
+                break;
+
+                default:
+                    return false;
+            }
+        break;
+
+        case 0x9000:
+            skip = ~CHIP8_POOL_LANES_EQUAL(a, b);
+        break;
+
+        case 0xA000:
+            CHIP8_POOL_LANES_STORE(&pool->I[start], (pc ^ pc) + nnn, *wide_mask);
+        break;
+
+        // Only keys 0 - F can be down. Shifting every lane by its own amount has no SSE2 / AVX2 instruction for 16-bit
+        // lanes, so the bit of key k is picked with 1 << k built from the bits of k: 2^1, 2^2, 2^4 and 2^8 multiplied in.
+        case 0xE000:
+        {
+            if (kk != 0x9E && kk != 0xA1) {
+                return false;
+            }
+
+            chip8_pool_wide_lanes keys;
+            CHIP8_POOL_LANES_LOAD(keys, &pool->keys[start]);
+            chip8_pool_wide_lanes key = __builtin_convertvector(a, chip8_pool_wide_lanes);
+            chip8_pool_wide_lanes bit = (1 + (key & 1)) * (1 + 3 * ((key >> 1) & 1)) * (1 + 15 * ((key >> 2) & 1)) *
+                (1 + 255 * ((key >> 3) & 1));
+            chip8_pool_wide_lanes zero = key ^ key;
+            chip8_pool_wide_lanes up = CHIP8_POOL_WIDE_LANES_EQUAL(keys & bit, zero) | ~CHIP8_POOL_WIDE_LANES_EQUAL(key >> 4, zero);
+            skip = __builtin_convertvector(kk == 0x9E ? ~up : up, chip8_pool_lanes);
+        }
+        break;
+
+        case 0xF000:
+            switch (kk) {
+                case 0x07:
+                {
+                    chip8_pool_lanes timer;
+                    CHIP8_POOL_LANES_LOAD(timer, &pool->delay_timer[start]);
+                    CHIP8_POOL_LANES_STORE(vx, timer, mask);
+                }
+                break;
+
+                // Lanes with no key down stay on the instruction. The others load the lowest key that is down: The
+                // number of the only bit set in keys & -keys, one bit of the number at a time.
+                case 0x0A:
+                {
+                    chip8_pool_wide_lanes keys;
+                    CHIP8_POOL_LANES_LOAD(keys, &pool->keys[start]);
+                    chip8_pool_wide_lanes zero = keys ^ keys;
+                    chip8_pool_wide_lanes lowest = keys & -keys;
+                    chip8_pool_wide_lanes key = (~CHIP8_POOL_WIDE_LANES_EQUAL(lowest & 0xff00, zero) & 8) |
+                        (~CHIP8_POOL_WIDE_LANES_EQUAL(lowest & 0xf0f0, zero) & 4) |
+                        (~CHIP8_POOL_WIDE_LANES_EQUAL(lowest & 0xcccc, zero) & 2) |
+                        (~CHIP8_POOL_WIDE_LANES_EQUAL(lowest & 0xaaaa, zero) & 1);
+                    chip8_pool_wide_lanes waiting = CHIP8_POOL_WIDE_LANES_EQUAL(keys, zero);
+                    CHIP8_POOL_LANES_STORE(vx, __builtin_convertvector(key, chip8_pool_lanes),
+                        mask & ~__builtin_convertvector(waiting, chip8_pool_lanes));
+                    pc -= waiting & 2;
+                }
+                break;
+
+                case 0x15:
+                    CHIP8_POOL_LANES_STORE(&pool->delay_timer[start], a, mask);
+                break;
+
+                case 0x18:
+                    CHIP8_POOL_LANES_STORE(&pool->sound_timer[start], a, mask);
+                break;
+
+                case 0x1E:
+                {
+                    chip8_pool_wide_lanes I;
+                    CHIP8_POOL_LANES_LOAD(I, &pool->I[start]);
+                    CHIP8_POOL_LANES_STORE(&pool->I[start], I + __builtin_convertvector(a, chip8_pool_wide_lanes), *wide_mask);
+                }
+                break;
+
+                default:
+                    return false;
+            }
+        break;
+
+        default:
+            return false;
+    }
+
+    pc += __builtin_convertvector(skip & 2, chip8_pool_wide_lanes);
+    CHIP8_POOL_LANES_STORE(&pool->PC[start], pc, *wide_mask);
+    return true;
+}
+
+// Number of lanes set in a mask, through its 64-bit words: The multiplication adds the four lanes of a word up
+// into its top 16 bits
+static int chip8_pool_count_lanes(const chip8_pool_wide_lanes* mask) {
+    uint64_t words[sizeof(chip8_pool_wide_lanes) / 8];
+    memcpy(words, mask, sizeof(words));
+    uint64_t sum = 0;
+    for (size_t w = 0; w < sizeof(words) / 8; w++) {
+        sum += words[w] & 0x0001000100010001;
+    }
+    return (sum * 0x0001000100010001) >> 48;
+}
+
+// First lane set in a mask, CHIP8_POOL_LANES if none is
+static int chip8_pool_first_lane(const chip8_pool_wide_lanes* mask) {
+    uint64_t words[sizeof(chip8_pool_wide_lanes) / 8];
+    memcpy(words, mask, sizeof(words));
+    for (size_t w = 0; w < sizeof(words) / 8; w++) {
+        if (words[w]) {
+            return w * 4 + __builtin_ctzll(words[w]) / 16;
+        }
+    }
+    return CHIP8_POOL_LANES;
+}
+
+// Steps CHIP8_POOL_LANES neighbouring instances one instruction. The lanes running the most common opcode (Instances
+// of the same ROM following the same path) are executed at once with vector instructions, the others one by one.
+static void chip8_pool_step_lanes(struct chip8_pool* pool, size_t start) {
+    chip8_pool_wide_lanes pcs;
+    CHIP8_POOL_LANES_LOAD(pcs, &pool->PC[start]);
+
+    // Opcodes are fetched with one unaligned 16-bit load per lane, unless an instruction of some lane is not entirely
+    // in memory: Then every lane goes through POOL_ADDRESS, which wraps the address around and raises the trap
+    chip8_pool_wide_lanes out = (pcs | (pcs + 1)) & ~(CHIP8_MEMORY_SIZE - 1);
+    unsigned short opcodes[CHIP8_POOL_LANES];
+    if (chip8_pool_first_lane(&out) == CHIP8_POOL_LANES) {
+        for (int l = 0; l < CHIP8_POOL_LANES; l++) {
+            unsigned short opcode;
+            memcpy(&opcode, &pool->memory[(start + l) * CHIP8_POOL_MEMORY_STRIDE + pcs[l]], sizeof(opcode));
+            opcodes[l] = __builtin_bswap16(opcode); // Big endian in memory
+        }
+    } else {
+        for (int l = 0; l < CHIP8_POOL_LANES; l++) {
+            size_t i = start + l;
+            opcodes[l] = POOL_MEMORY(POOL_ADDRESS(pcs[l])) << 8 | POOL_MEMORY(POOL_ADDRESS(pcs[l] + 1));
+        }
+    }
+
+    chip8_pool_wide_lanes fetched;
+    CHIP8_POOL_LANES_LOAD(fetched, opcodes);
+
+    // Every round counts the lanes sharing the opcode of the first lane not counted yet, until no opcode can have
+    // more lanes than the largest group found, or CHIP8_POOL_GROUP_ROUNDS rounds (Lanes rarely split many ways)
+    chip8_pool_wide_lanes group = fetched ^ fetched;
+    chip8_pool_wide_lanes left = group - 1;
+    unsigned short opcode = 0;
+    int group_size = 0;
+    int remaining = CHIP8_POOL_LANES;
+    for (int round = 0; round < CHIP8_POOL_GROUP_ROUNDS && group_size < remaining; round++) {
+        unsigned short candidate = opcodes[chip8_pool_first_lane(&left)];
+        chip8_pool_wide_lanes same = CHIP8_POOL_WIDE_LANES_EQUAL(fetched, (fetched ^ fetched) + candidate);
+        left &= ~same;
+        int size = chip8_pool_count_lanes(&same);
+        remaining -= size;
+
+        if (size > group_size) {
+            group = same;
+            group_size = size;
+            opcode = candidate;
+        }
+    }
+
+    if (group_size < CHIP8_POOL_MIN_LANES || !chip8_pool_exec_lanes(pool, start, opcode, &group)) {
+        group ^= group;
+    }
+
+    unsigned short vectorized[CHIP8_POOL_LANES];
+    CHIP8_POOL_LANES_LOAD(vectorized, &group);
+    for (int l = 0; l < CHIP8_POOL_LANES; l++) {
+        size_t i = start + l;
+        if (!vectorized[l]) {
+            pool->PC[i] += 2;
+            chip8_pool_exec(pool, i, opcodes[l]);
+        }
+    }
+
+    for (int l = 0; l < CHIP8_POOL_LANES; l++) {
+        pool->cycles[start + l] += 1;
+    }
+}
+
+void chip8_pool_run(struct chip8_pool* pool, int cycles) {
+    // Instances are processed in tiles: All instances of a tile advance one instruction before any of them executes
+    // the next one, and the tile runs every cycle before moving on, so its slice of each state array stays in cache
+    for (size_t start = 0; start < pool->count; start += CHIP8_POOL_TILE) {
+        size_t end = start + CHIP8_POOL_TILE < pool->count ? start + CHIP8_POOL_TILE : pool->count;
+
+        for (int c = 0; c < cycles; c++) {
+            size_t i = start;
+            for (; i + CHIP8_POOL_LANES <= end; i += CHIP8_POOL_LANES) {
+                chip8_pool_step_lanes(pool, i);
+            }
+
+            // Leftover instances at the end of the pool that do not fill a whole vector
+            for (; i < end; i++) {
+                unsigned short pc = pool->PC[i];
+                unsigned short opcode = POOL_MEMORY(POOL_ADDRESS(pc)) << 8 | POOL_MEMORY(POOL_ADDRESS(pc + 1));
+                pool->PC[i] = pc + 2;
+                chip8_pool_exec(pool, i, opcode);
+                pool->cycles[i] += 1;
+            }
+        }
+    }
+}
+
+void chip8_pool_run_frame(struct chip8_pool* pool) {
+    chip8_pool_run(pool, CHIP8_CYCLES_PER_FRAME);
+
+    for (size_t i = 0; i < pool->count; i++) {
+        pool->delay_timer[i] -= pool->delay_timer[i] > 0;
+        pool->sound_timer[i] -= pool->sound_timer[i] > 0;
+    }
+}
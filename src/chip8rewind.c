@@ -0,0 +1,196 @@
+#include "chip8rewind.h"
+#include "chip8.h"
+#include "chip8endian.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Deltas are a list of records: u16 count of unchanged bytes, u16 count of changed bytes, then the changed bytes
+// XORed with the keyframe. Runs of less than 4 unchanged bytes are cheaper to store as changed bytes.
+#define CHIP8_REWIND_MIN_RUN 4
+
+static size_t chip8_rewind_encode(const unsigned char* keyframe, const unsigned char* state, size_t size, unsigned char* out) {
+    unsigned char* p = out;
+    size_t i = 0;
+
+    while (i < size) {
+        size_t same = i;
+        while (same < size && state[same] == keyframe[same] && same - i < 0xffff) {
+            same++;
+        }
+
+        // Changed bytes continue until a long enough run of unchanged bytes (Or the end) is found
+        size_t changed = same;
+        size_t run = 0;
+        while (changed + run < size && changed - same < 0xffff) {
+            if (state[changed + run] == keyframe[changed + run]) {
+                run++;
+                if (run == CHIP8_REWIND_MIN_RUN) {
+                    break;
+                }
+                continue;
+            }
+            changed += run + 1;
+            run = 0;
+        }
+        if (changed - same > 0xffff) {
+            changed = same + 0xffff;
+        }
+
+        chip8_put16(p, same - i);
+        chip8_put16(p + 2, changed - same);
+        p += 4;
+        for (size_t j = same; j < changed; j++) {
+            *p++ = state[j] ^ keyframe[j];
+        }
+
+        i = changed;
+    }
+
+    return p - out;
+}
+
+static void chip8_rewind_decode(const unsigned char* delta, size_t delta_size, unsigned char* state) {
+    const unsigned char* p = delta;
+    const unsigned char* end = delta + delta_size;
+    size_t i = 0;
+
+    while (p < end) {
+        i += chip8_get16(p);
+        size_t changed = chip8_get16(p + 2);
+        p += 4;
+        for (size_t j = 0; j < changed; j++) {
+            state[i++] ^= *p++;
+        }
+    }
+}
+
+void chip8_rewind_init(struct chip8_rewind* rewind, size_t budget, int keyframe_interval) {
+    memset(rewind, 0, sizeof(struct chip8_rewind));
+    rewind->budget = budget;
+    rewind->keyframe_interval = keyframe_interval > 0 ? keyframe_interval : 1;
+}
+
+static struct chip8_rewind_entry* chip8_rewind_entry(struct chip8_rewind* rewind, size_t index) {
+    return &rewind->entries[(rewind->start + index) % rewind->capacity];
+}
+
+static void chip8_rewind_drop_oldest(struct chip8_rewind* rewind) {
+    struct chip8_rewind_entry* entry = chip8_rewind_entry(rewind, 0);
+    rewind->used -= entry->size;
+    free(entry->data);
+    entry->data = NULL;
+    rewind->start = (rewind->start + 1) % rewind->capacity;
+    rewind->count -= 1;
+}
+
+void chip8_rewind_free(struct chip8_rewind* rewind) {
+    while (rewind->count > 0) {
+        chip8_rewind_drop_oldest(rewind);
+    }
+    free(rewind->entries);
+    rewind->entries = NULL;
+    rewind->capacity = 0;
+}
+
+static int chip8_rewind_grow(struct chip8_rewind* rewind) {
+    size_t capacity = rewind->capacity ? rewind->capacity * 2 : 256;
+    struct chip8_rewind_entry* entries = malloc(capacity * sizeof(struct chip8_rewind_entry));
+    if (!entries) {
+        return -1;
+    }
+
+    // Unwrap the ring so the oldest entry is at index 0 again
+    for (size_t i = 0; i < rewind->count; i++) {
+        entries[i] = *chip8_rewind_entry(rewind, i);
+    }
+
+    free(rewind->entries);
+    rewind->entries = entries;
+    rewind->capacity = capacity;
+    rewind->start = 0;
+    return 0;
+}
+
+int chip8_rewind_push(struct chip8_rewind* rewind, const struct chip8* chip8) {
+    unsigned char* state = rewind->scratch;
+    unsigned char* delta = rewind->scratch + CHIP8_SAVE_STATE_SIZE;
+    size_t state_size = chip8_save_state(chip8, state, CHIP8_SAVE_STATE_SIZE);
+
+    // A state of another size (Memory size changed with the quirks) can't be a delta against the keyframe either
+    bool keyframe = rewind->count == 0 || rewind->since_keyframe >= rewind->keyframe_interval || state_size != rewind->keyframe_size;
+    size_t size = state_size;
+    if (!keyframe) {
+        size = chip8_rewind_encode(rewind->keyframe, state, state_size, delta);
+    }
+
+    // Make room, a keyframe takes all of its deltas with it since they can no longer be decoded
+    while (rewind->count > 0 && rewind->used + size > rewind->budget) {
+        chip8_rewind_drop_oldest(rewind);
+        while (rewind->count > 0 && !chip8_rewind_entry(rewind, 0)->keyframe) {
+            chip8_rewind_drop_oldest(rewind);
+        }
+    }
+
+    // The keyframe this delta was taken against got dropped
+    if (!keyframe && rewind->count == 0) {
+        keyframe = true;
+        size = state_size;
+    }
+
+    if (rewind->count == rewind->capacity && chip8_rewind_grow(rewind) != 0) {
+        return -1;
+    }
+
+    unsigned char* data = malloc(size);
+    if (!data) {
+        return -1;
+    }
+    memcpy(data, keyframe ? state : delta, size);
+
+    if (keyframe) {
+        memcpy(rewind->keyframe, state, state_size);
+        rewind->keyframe_size = state_size;
+        rewind->since_keyframe = 0;
+    }
+    rewind->since_keyframe += 1;
+
+    struct chip8_rewind_entry* entry = chip8_rewind_entry(rewind, rewind->count);
+    entry->data = data;
+    entry->size = size;
+    entry->keyframe = keyframe;
+    rewind->count += 1;
+    rewind->used += size;
+    return 0;
+}
+
+int chip8_rewind_pop(struct chip8_rewind* rewind, struct chip8* chip8) {
+    if (rewind->count == 0) {
+        return -1;
+    }
+
+    struct chip8_rewind_entry* entry = chip8_rewind_entry(rewind, rewind->count - 1);
+    unsigned char* state = rewind->scratch;
+
+    if (entry->keyframe) {
+        memcpy(state, entry->data, entry->size);
+    } else {
+        // Deltas are always preceded by their keyframe somewhere in the ring
+        size_t k = rewind->count - 1;
+        while (!chip8_rewind_entry(rewind, k)->keyframe) {
+            k--;
+        }
+        memcpy(state, chip8_rewind_entry(rewind, k)->data, chip8_rewind_entry(rewind, k)->size);
+        chip8_rewind_decode(entry->data, entry->size, state);
+    }
+
+    int res = chip8_load_state(chip8, state, CHIP8_SAVE_STATE_SIZE);
+
+    rewind->used -= entry->size;
+    free(entry->data);
+    entry->data = NULL;
+    rewind->count -= 1;
+
+    // Snapshots pushed after rewinding start a fresh keyframe rather than reusing the one in rewind->keyframe
+    rewind->since_keyframe = rewind->keyframe_interval;
+    return res;
+}
@@ -0,0 +1,101 @@
+#include "chip8rom.h"
+#include <string.h>
+
+#ifdef _WIN32
+
+#include <windows.h>
+
+int chip8_rom_open(struct chip8_rom* rom, const char* filename) {
+    memset(rom, 0, sizeof(struct chip8_rom));
+
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return -1;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return -1;
+    }
+
+    // Empty files can not be mapped, there is nothing to map anyway
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        return 0;
+    }
+
+    // The mapping object keeps the file open, the file handle itself is not needed anymore
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping) {
+        return -1;
+    }
+
+    const char* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(mapping);
+        return -1;
+    }
+
+    rom->data = data;
+    rom->size = size.QuadPart;
+    rom->handle = mapping;
+    return 0;
+}
+
+void chip8_rom_close(struct chip8_rom* rom) {
+    if (rom->data) {
+        UnmapViewOfFile(rom->data);
+        CloseHandle(rom->handle);
+    }
+    memset(rom, 0, sizeof(struct chip8_rom));
+}
+
+#else
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+int chip8_rom_open(struct chip8_rom* rom, const char* filename) {
+    memset(rom, 0, sizeof(struct chip8_rom));
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return -1;
+    }
+
+    // Empty files can not be mapped, there is nothing to map anyway
+    if (st.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+
+    // The mapping stays valid once the file is closed
+    void* data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return -1;
+    }
+
+    rom->data = data;
+    rom->size = st.st_size;
+    return 0;
+}
+
+void chip8_rom_close(struct chip8_rom* rom) {
+    if (rom->data) {
+        munmap((void*) rom->data, rom->size);
+    }
+    memset(rom, 0, sizeof(struct chip8_rom));
+}
+
+#endif
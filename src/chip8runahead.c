@@ -0,0 +1,46 @@
+#include "chip8runahead.h"
+#include <stdlib.h>
+
+int chip8_runahead_init(struct chip8_runahead* runahead, int frames) {
+    if (frames < 0) {
+        frames = 0;
+    }
+    if (frames > CHIP8_RUNAHEAD_MAX_FRAMES) {
+        frames = CHIP8_RUNAHEAD_MAX_FRAMES;
+    }
+    runahead->frames = frames;
+    runahead->snapshot = NULL;
+    if (frames > 0) {
+        runahead->snapshot = chip8_new(CHIP8_XO_MEMORY_SIZE);
+        if (!runahead->snapshot) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void chip8_runahead_free(struct chip8_runahead* runahead) {
+    free(runahead->snapshot);
+    runahead->snapshot = NULL;
+}
+
+void chip8_runahead_frame(struct chip8_runahead* runahead, struct chip8* chip8) {
+    chip8_run_frame(chip8);
+
+    if (runahead->frames == 0) {
+        runahead->screen = chip8->screen;
+        return;
+    }
+
+    // A plain copy is the cheapest snapshot there is, the keyboard map pointer stays valid within the process
+    chip8_copy(runahead->snapshot, chip8);
+    for (int i = 0; i < runahead->frames; i++) {
+        chip8_run_frame(chip8);
+    }
+    runahead->screen = chip8->screen;
+
+    // The copy only knows how much memory the snapshot addresses, the chip8 keeps the room it was allocated with
+    unsigned int capacity = chip8->memory.capacity;
+    chip8_copy(chip8, runahead->snapshot);
+    chip8->memory.capacity = capacity;
+}
@@ -0,0 +1,125 @@
+#include "chip8savestate.h"
+#include "chip8.h"
+#include "chip8endian.h"
+#include <string.h>
+
+static const unsigned char chip8_save_state_magic[4] = { 'C', '8', 'S', 'T' };
+
+// Size of a save state with the given quirks, which select the memory size
+static size_t chip8_save_state_quirks_size(unsigned char quirks) {
+    return CHIP8_SAVE_STATE_SIZE - CHIP8_XO_MEMORY_SIZE + (quirks & CHIP8_QUIRK_XO_CHIP ? CHIP8_XO_MEMORY_SIZE : CHIP8_MEMORY_SIZE);
+}
+
+size_t chip8_save_state_size(const struct chip8* chip8) {
+    return chip8_save_state_quirks_size(chip8->quirks);
+}
+
+size_t chip8_save_state(const struct chip8* chip8, unsigned char* buf, size_t size) {
+    if (size < chip8_save_state_size(chip8)) {
+        return 0;
+    }
+
+    unsigned char* p = buf;
+    memcpy(p, chip8_save_state_magic, sizeof(chip8_save_state_magic));
+    p += sizeof(chip8_save_state_magic);
+    chip8_put16(p, CHIP8_SAVE_STATE_VERSION);
+    p += 2;
+
+    memcpy(p, chip8->registers.V, CHIP8_TOTAL_DATA_REGISTERS);
+    p += CHIP8_TOTAL_DATA_REGISTERS;
+    chip8_put16(p, chip8->registers.I);
+    chip8_put16(p + 2, chip8->registers.PC);
+    chip8_put16(p + 4, chip8->registers.SP);
+    p += 6;
+    *p++ = chip8->registers.delay_timer;
+    *p++ = chip8->registers.sound_timer;
+
+    for (int i = 0; i < CHIP8_TOTAL_STACK_DEPTH; i++) {
+        chip8_put16(p, chip8->stack.stack[i]);
+        p += 2;
+    }
+
+    unsigned int keys = 0;
+    for (int i = 0; i < CHIP8_TOTAL_KEYS; i++) {
+        keys |= chip8->keyboard.keyboard[i] << i;
+    }
+    chip8_put16(p, keys);
+    p += 2;
+
+    chip8_put32(p, chip8->rng);
+    chip8_put64(p + 4, chip8->cycles);
+    p += 12;
+    *p++ = chip8->quirks;
+    *p++ = chip8->screen.hires;
+    *p++ = chip8->screen.plane_mask;
+    memcpy(p, chip8->flags, CHIP8_TOTAL_RPL_FLAGS);
+    p += CHIP8_TOTAL_RPL_FLAGS;
+    memcpy(p, chip8->audio_pattern, CHIP8_AUDIO_PATTERN_SIZE);
+    p += CHIP8_AUDIO_PATTERN_SIZE;
+    *p++ = chip8->pitch;
+
+    // The quirks (Stored above) give the memory size, chip8_set_quirks picks the same one on load
+    memcpy(p, chip8->memory.memory, chip8_memory_size(&chip8->memory));
+    p += chip8_memory_size(&chip8->memory);
+
+    chip8_screen_pack(&chip8->screen, p);
+    p += CHIP8_SCREEN_PACKED_SIZE;
+
+    return p - buf;
+}
+
+int chip8_load_state(struct chip8* chip8, const unsigned char* buf, size_t size) {
+    // Everything is validated before the chip8 is touched, so a bad blob never leaves a half loaded state behind
+    if (size < CHIP8_SAVE_STATE_HEADER_SIZE + 1 || memcmp(buf, chip8_save_state_magic, sizeof(chip8_save_state_magic)) != 0 ||
+        chip8_get16(buf + sizeof(chip8_save_state_magic)) != CHIP8_SAVE_STATE_VERSION ||
+        size < chip8_save_state_quirks_size(buf[CHIP8_SAVE_STATE_HEADER_SIZE]) ||
+        ((buf[CHIP8_SAVE_STATE_HEADER_SIZE] & CHIP8_QUIRK_XO_CHIP) && chip8->memory.capacity < CHIP8_XO_MEMORY_SIZE)) {
+        return -1;
+    }
+
+    // I, PC, SP and the return addresses are restored as they are, even out of range: Every memory and stack access
+    // wraps them around (See CHIP8_TRAP_MEMORY and CHIP8_TRAP_STACK), and the core leaves them out of range itself,
+    // e.g. after Fx1E moves I past the memory or a release build overflows the stack
+    const unsigned char* p = buf + sizeof(chip8_save_state_magic) + 2;
+    memcpy(chip8->registers.V, p, CHIP8_TOTAL_DATA_REGISTERS);
+    p += CHIP8_TOTAL_DATA_REGISTERS;
+    chip8->registers.I = chip8_get16(p);
+    chip8->registers.PC = chip8_get16(p + 2);
+    chip8->registers.SP = chip8_get16(p + 4);
+    p += 6;
+    chip8->registers.delay_timer = *p++;
+    chip8->registers.sound_timer = *p++;
+
+    for (int i = 0; i < CHIP8_TOTAL_STACK_DEPTH; i++) {
+        chip8->stack.stack[i] = chip8_get16(p);
+        p += 2;
+    }
+
+    unsigned int keys = chip8_get16(p);
+    p += 2;
+    for (int i = 0; i < CHIP8_TOTAL_KEYS; i++) {
+        chip8->keyboard.keyboard[i] = (keys >> i) & 1;
+    }
+
+    chip8->rng = chip8_get32(p);
+    chip8->cycles = chip8_get64(p + 4);
+    p += 12;
+    chip8_set_quirks(chip8, *p++);
+
+    chip8_screen_init(&chip8->screen);
+    chip8->screen.hires = *p++;
+    chip8_screen_select_planes(&chip8->screen, *p++);
+    memcpy(chip8->flags, p, CHIP8_TOTAL_RPL_FLAGS);
+    p += CHIP8_TOTAL_RPL_FLAGS;
+    memcpy(chip8->audio_pattern, p, CHIP8_AUDIO_PATTERN_SIZE);
+    p += CHIP8_AUDIO_PATTERN_SIZE;
+    chip8->pitch = *p++;
+
+    // chip8_set_quirks selected the memory size the state was saved with
+    memcpy(chip8->memory.memory, p, chip8_memory_size(&chip8->memory));
+    p += chip8_memory_size(&chip8->memory);
+
+    chip8_screen_unpack(&chip8->screen, p);
+
+    return 0;
+}
@@ -0,0 +1,158 @@
+#include "chip8sched.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Deque of job indices. A mutex per deque is plenty: Taking a job costs nothing next to running a slice of it.
+struct chip8_sched_deque {
+    pthread_mutex_t lock;
+    size_t* jobs; // Ring of job indices
+    size_t capacity;
+    size_t start;
+    size_t count;
+};
+
+struct chip8_sched {
+    struct chip8_job* jobs;
+    struct chip8_sched_deque* deques;
+    int threads;
+    atomic_size_t remaining; // Jobs not done yet, threads stop once it reaches 0
+};
+
+struct chip8_sched_worker {
+    struct chip8_sched* sched;
+    int index;
+};
+
+static void chip8_sched_push(struct chip8_sched_deque* deque, size_t job) {
+    pthread_mutex_lock(&deque->lock);
+    deque->jobs[(deque->start + deque->count) % deque->capacity] = job;
+    deque->count += 1;
+    pthread_mutex_unlock(&deque->lock);
+}
+
+// Owner side: Most recently pushed job, its state is still in this thread's cache
+static bool chip8_sched_pop_back(struct chip8_sched_deque* deque, size_t* job) {
+    pthread_mutex_lock(&deque->lock);
+    bool found = deque->count > 0;
+    if (found) {
+        deque->count -= 1;
+        *job = deque->jobs[(deque->start + deque->count) % deque->capacity];
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+// Thief side: Oldest job of the deque
+static bool chip8_sched_pop_front(struct chip8_sched_deque* deque, size_t* job) {
+    pthread_mutex_lock(&deque->lock);
+    bool found = deque->count > 0;
+    if (found) {
+        *job = deque->jobs[deque->start];
+        deque->start = (deque->start + 1) % deque->capacity;
+        deque->count -= 1;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+static bool chip8_sched_steal(struct chip8_sched* sched, int thief, size_t* job) {
+    // Victims are tried in order starting after the thief, so not every thread hammers thread 0 first
+    for (int i = 1; i < sched->threads; i++) {
+        if (chip8_sched_pop_front(&sched->deques[(thief + i) % sched->threads], job)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void* chip8_sched_worker(void* arg) {
+    struct chip8_sched_worker* worker = arg;
+    struct chip8_sched* sched = worker->sched;
+    struct chip8_sched_deque* own = &sched->deques[worker->index];
+
+    while (atomic_load(&sched->remaining) > 0) {
+        size_t job;
+        if (!chip8_sched_pop_back(own, &job) && !chip8_sched_steal(sched, worker->index, &job)) {
+            sched_yield(); // Every job left is being run by another thread right now
+            continue;
+        }
+
+        if (chip8_job_run(&sched->jobs[job], CHIP8_SCHED_SLICE_FRAMES)) {
+            atomic_fetch_sub(&sched->remaining, 1);
+        } else {
+            chip8_sched_push(own, job);
+        }
+    }
+
+    return NULL;
+}
+
+int chip8_sched_run(struct chip8_job* jobs, size_t count, int threads) {
+    if (threads <= 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cores > 0 ? cores : 1;
+    }
+
+    struct chip8_sched sched;
+    sched.jobs = jobs;
+    sched.threads = threads;
+    atomic_init(&sched.remaining, 0);
+
+    sched.deques = calloc(threads, sizeof(struct chip8_sched_deque));
+    pthread_t* ids = calloc(threads, sizeof(pthread_t));
+    struct chip8_sched_worker* workers = calloc(threads, sizeof(struct chip8_sched_worker));
+    int res = sched.deques && ids && workers ? 0 : -1;
+
+    // A job is only ever in one deque, so every deque can hold all of them
+    int initialized = 0;
+    for (; res == 0 && initialized < threads; initialized++) {
+        struct chip8_sched_deque* deque = &sched.deques[initialized];
+        deque->capacity = count > 0 ? count : 1;
+        deque->jobs = malloc(deque->capacity * sizeof(size_t));
+        if (!deque->jobs) {
+            res = -1;
+            break;
+        }
+        pthread_mutex_init(&deque->lock, NULL);
+    }
+
+    if (res == 0) {
+        // Jobs are dealt out round robin, stealing evens out whatever imbalance that leaves
+        for (size_t i = 0; i < count; i++) {
+            if (!jobs[i].done) {
+                chip8_sched_push(&sched.deques[i % threads], i);
+                atomic_fetch_add(&sched.remaining, 1);
+            }
+        }
+
+        int started = 0;
+        for (; started < threads; started++) {
+            workers[started].sched = &sched;
+            workers[started].index = started;
+            if (pthread_create(&ids[started], NULL, chip8_sched_worker, &workers[started]) != 0) {
+                break;
+            }
+        }
+
+        // With at least one thread running every job still gets done, just more slowly
+        if (started == 0) {
+            res = -1;
+        }
+
+        for (int i = 0; i < started; i++) {
+            pthread_join(ids[i], NULL);
+        }
+    }
+
+    for (int i = 0; i < initialized; i++) {
+        pthread_mutex_destroy(&sched.deques[i].lock);
+        free(sched.deques[i].jobs);
+    }
+    free(sched.deques);
+    free(ids);
+    free(workers);
+    return res;
+}
@@ -3,48 +3,217 @@
 #include <assert.h>
 #include <memory.h>
 
-static void chip8_screen_check_bounds(int x, int y) {
-    assert(x >= 0 && x < CHIP8_WIDTH && y >= 0 && y < CHIP8_HEIGHT);
+static void chip8_screen_check_bounds(const struct chip8_screen* screen, int x, int y) {
+    assert(x >= 0 && x < chip8_screen_width(screen) && y >= 0 && y < chip8_screen_height(screen));
+}
+
+int chip8_screen_width(const struct chip8_screen* screen) {
+    return screen->hires ? CHIP8_HIRES_WIDTH : CHIP8_WIDTH;
+}
+
+int chip8_screen_height(const struct chip8_screen* screen) {
+    return screen->hires ? CHIP8_HIRES_HEIGHT : CHIP8_HEIGHT;
 }
 
 // Setting a pixel on the chip8 screen (Specifying x and y)
 void chip8_screen_set(struct chip8_screen* screen, int x, int y) {
-    chip8_screen_check_bounds(x, y);
-    screen->pixels[y][x] = true;
+    chip8_screen_check_bounds(screen, x, y);
+    for (int p = 0; p < CHIP8_TOTAL_PLANES; p++) {
+        if (screen->plane_mask & (1 << p)) {
+            screen->planes[p][y][x / 64] |= (uint64_t) 1 << (63 - x % 64);
+        }
+    }
+}
+
+static void chip8_screen_clear_planes(struct chip8_screen* screen, unsigned char plane_mask) {
+    for (int p = 0; p < CHIP8_TOTAL_PLANES; p++) {
+        if (plane_mask & (1 << p)) {
+            memset(screen->planes[p], 0, sizeof(screen->planes[p]));
+        }
+    }
+}
+
+void chip8_screen_init(struct chip8_screen* screen) {
+    memset(screen, 0, sizeof(struct chip8_screen));
+    screen->plane_mask = 1;
 }
 
 void chip8_screen_clear(struct chip8_screen* screen) {
-    memset(screen->pixels, 0, sizeof(screen->pixels));
+    chip8_screen_clear_planes(screen, screen->plane_mask);
+}
+
+void chip8_screen_set_hires(struct chip8_screen* screen, bool hires) {
+    screen->hires = hires;
+    chip8_screen_clear_planes(screen, (1 << CHIP8_TOTAL_PLANES) - 1);
+}
+
+void chip8_screen_select_planes(struct chip8_screen* screen, unsigned char plane_mask) {
+    screen->plane_mask = plane_mask & ((1 << CHIP8_TOTAL_PLANES) - 1);
+}
+
+unsigned char chip8_screen_get(const struct chip8_screen* screen, int x, int y) {
+    chip8_screen_check_bounds(screen, x, y);
+    unsigned char color = 0;
+    for (int p = 0; p < CHIP8_TOTAL_PLANES; p++) {
+        color |= ((screen->planes[p][y][x / 64] >> (63 - x % 64)) & 1) << p;
+    }
+    return color;
 }
 
 // Checking if a pixel is set on a certain x and y coord (This checking is used during rendering)
-bool chip8_screen_is_set(struct chip8_screen* screen, int x, int y) {
-    chip8_screen_check_bounds(x, y);
-    return screen->pixels[y][x];
+bool chip8_screen_is_set(const struct chip8_screen* screen, int x, int y) {
+    return chip8_screen_get(screen, x, y) != 0;
+}
+
+bool chip8_screen_equal(const struct chip8_screen* a, const struct chip8_screen* b) {
+    return a->hires == b->hires && memcmp(a->planes, b->planes, sizeof(a->planes)) == 0;
+}
+
+// XORs a sprite row (Left aligned in bits) into a row of a plane, starting at pixel x (Within the screen). Pixels past
+// the right edge wrap around to the left, or are dropped when clipping. Returns true if a set pixel was erased.
+static bool chip8_screen_xor_row(uint64_t* row, bool hires, uint64_t bits, int x, bool clip) {
+    int words = hires ? 2 : 1;
+    int word = x / 64;
+    int next = word + 1 < words ? word + 1 : 0;
+    uint64_t first = bits >> (x % 64);
+    uint64_t spill = x % 64 ? bits << (64 - x % 64) : 0;
+    if (clip && next == 0) {
+        spill = 0;
+    }
+
+    bool collision = (row[word] & first) || (row[next] & spill);
+    row[word] ^= first;
+    row[next] ^= spill;
+    return collision;
 }
 
 // The chip8 interpreter reads n bytes from memory, starting at address stored in I. These bytes are then displayed as sprites 
 // at coordinates x and y. 
 // ==> Sprites are XORed onto the existing screen. If this causes any pixels to be erased, VF = 1, else VF = 0
-// ==> If sprite overflows outside of the screen, it wraps around to the opposite side of screen.
-bool chip8_screen_draw_sprite(struct chip8_screen* screen, int x, int y, const char* sprite, int num) {
+// ==> If sprite overflows outside of the screen, it wraps around to the opposite side of screen (Unless clipping).
+// ==> Every selected plane gets its own sprite, read right after the previous plane's one
+static bool chip8_screen_draw(struct chip8_screen* screen, int x, int y, const char* sprite, int num, bool clip) {
     // We change this variable to true if the sprite was "hit" (i.e if a pixel was changed)
     bool pixel_collision = false;
+    int height = chip8_screen_height(screen);
+    bool wide = num == 0 && screen->hires;
+    const unsigned char* bytes = (const unsigned char*) sprite;
 
-    for (int ly = 0; ly < num; ly++) { // Looping through rows of bytes
-        char c = sprite[ly]; // Give the byte in the sprite
+    x %= chip8_screen_width(screen);
+    y %= height;
+    if (wide) {
+        num = 16;
+    }
 
-        for (int lx = 0; lx < 8; lx++) { // Each byte is 8 bits, hence lx < 8
-            // If the current bit is 0, then no pixel is set
-            if ((c & (0b10000000 >> lx)) == 0)
-                continue;
+    for (int p = 0; p < CHIP8_TOTAL_PLANES; p++) {
+        if (!(screen->plane_mask & (1 << p))) {
+            continue;
+        }
 
-            if (screen->pixels[(ly+y) % CHIP8_HEIGHT][(lx+x) % CHIP8_WIDTH]) {
-                pixel_collision = true;
+        for (int ly = 0; ly < num; ly++) { // Looping through rows of bytes
+            if (clip && ly + y >= height) {
+                break;
             }
-            screen->pixels[(ly+y) % CHIP8_HEIGHT][(lx+x) % CHIP8_WIDTH] ^= true; // XOR
+
+            uint64_t bits = wide ? (uint64_t) (bytes[ly * 2] << 8 | bytes[ly * 2 + 1]) << 48 : (uint64_t) bytes[ly] << 56;
+            pixel_collision |= chip8_screen_xor_row(screen->planes[p][(ly + y) % height], screen->hires, bits, x, clip);
         }
+        bytes += wide ? 32 : num;
     }
 
     return pixel_collision;
-}
\ No newline at end of file
+}
+
+bool chip8_screen_draw_sprite(struct chip8_screen* screen, int x, int y, const char* sprite, int num) {
+    return chip8_screen_draw(screen, x, y, sprite, num, false);
+}
+
+bool chip8_screen_draw_sprite_clipped(struct chip8_screen* screen, int x, int y, const char* sprite, int num) {
+    return chip8_screen_draw(screen, x, y, sprite, num, true);
+}
+
+void chip8_screen_scroll_down(struct chip8_screen* screen, int rows) {
+    int height = chip8_screen_height(screen);
+    if (rows > height) {
+        rows = height;
+    }
+
+    for (int p = 0; p < CHIP8_TOTAL_PLANES; p++) {
+        if (screen->plane_mask & (1 << p)) {
+            memmove(screen->planes[p][rows], screen->planes[p][0], (height - rows) * sizeof(screen->planes[p][0]));
+            memset(screen->planes[p][0], 0, rows * sizeof(screen->planes[p][0]));
+        }
+    }
+}
+
+void chip8_screen_scroll_up(struct chip8_screen* screen, int rows) {
+    int height = chip8_screen_height(screen);
+    if (rows > height) {
+        rows = height;
+    }
+
+    for (int p = 0; p < CHIP8_TOTAL_PLANES; p++) {
+        if (screen->plane_mask & (1 << p)) {
+            memmove(screen->planes[p][0], screen->planes[p][rows], (height - rows) * sizeof(screen->planes[p][0]));
+            memset(screen->planes[p][height - rows], 0, rows * sizeof(screen->planes[p][0]));
+        }
+    }
+}
+
+void chip8_screen_scroll_right(struct chip8_screen* screen) {
+    for (int p = 0; p < CHIP8_TOTAL_PLANES; p++) {
+        if (!(screen->plane_mask & (1 << p))) {
+            continue;
+        }
+        for (int y = 0; y < chip8_screen_height(screen); y++) {
+            uint64_t* row = screen->planes[p][y];
+            if (screen->hires) {
+                row[1] = row[1] >> 4 | row[0] << 60;
+            }
+            row[0] >>= 4;
+        }
+    }
+}
+
+void chip8_screen_scroll_left(struct chip8_screen* screen) {
+    for (int p = 0; p < CHIP8_TOTAL_PLANES; p++) {
+        if (!(screen->plane_mask & (1 << p))) {
+            continue;
+        }
+        for (int y = 0; y < chip8_screen_height(screen); y++) {
+            uint64_t* row = screen->planes[p][y];
+            if (screen->hires) {
+                row[0] = row[0] << 4 | row[1] >> 60;
+                row[1] <<= 4;
+            } else {
+                row[0] <<= 4;
+            }
+        }
+    }
+}
+
+void chip8_screen_pack(const struct chip8_screen* screen, unsigned char* out) {
+    for (int p = 0; p < CHIP8_TOTAL_PLANES; p++) {
+        for (int y = 0; y < CHIP8_HIRES_HEIGHT; y++) {
+            for (int w = 0; w < 2; w++) {
+                for (int b = 56; b >= 0; b -= 8) {
+                    *out++ = screen->planes[p][y][w] >> b;
+                }
+            }
+        }
+    }
+}
+
+void chip8_screen_unpack(struct chip8_screen* screen, const unsigned char* in) {
+    for (int p = 0; p < CHIP8_TOTAL_PLANES; p++) {
+        for (int y = 0; y < CHIP8_HIRES_HEIGHT; y++) {
+            for (int w = 0; w < 2; w++) {
+                uint64_t word = 0;
+                for (int b = 0; b < 8; b++) {
+                    word = word << 8 | *in++;
+                }
+                screen->planes[p][y][w] = word;
+            }
+        }
+    }
+}
@@ -0,0 +1,331 @@
+#include "chip8search.h"
+#include "chip8hash.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define CHIP8_SEARCH_CHUNK 256 // Frontier states expanded together, bounds the memory used by their children
+#define CHIP8_SEARCH_ROOT SIZE_MAX
+
+// Frontier and children states are stored chip8_size bytes apart rather than as whole structs, so plain ROMs only
+// take about 5 KB per state instead of the 64 KB of XO-CHIP memory. They are emulated in a full struct per thread.
+#define CHIP8_SEARCH_STATE(states, stride, i) ((struct chip8*) ((unsigned char*) (states) + (i) * (stride)))
+
+// Every state ever reached, as the node it was reached from plus the choice that led to it, so paths can be rebuilt
+struct chip8_search_node {
+    size_t parent;
+    signed char choice;
+};
+
+// Open addressing set of state hashes (0 marks an empty slot)
+struct chip8_search_set {
+    uint64_t* slots;
+    size_t capacity;
+    size_t count;
+};
+
+struct chip8_search_chunk {
+    const struct chip8_search* search;
+    const unsigned char* parents;
+    unsigned char* children;
+    size_t stride;
+    struct chip8* scratch; // State the children of this thread are emulated in, stride bytes
+    uint64_t* hashes;
+    bool* goals;
+    size_t count;
+    int thread;
+    int threads;
+};
+
+void chip8_search_init(struct chip8_search* search, chip8_search_goal_fn goal, void* user) {
+    memset(search, 0, sizeof(struct chip8_search));
+    search->frames_per_decision = 10;
+    search->max_depth = 30;
+    search->max_frontier = 16384;
+    search->goal = goal;
+    search->user = user;
+}
+
+void chip8_search_free(struct chip8_search* search) {
+    free(search->state);
+    search->state = NULL;
+}
+
+static int chip8_search_set_grow(struct chip8_search_set* set) {
+    size_t capacity = set->capacity ? set->capacity * 2 : 4096;
+    uint64_t* slots = calloc(capacity, sizeof(uint64_t));
+    if (!slots) {
+        return -1;
+    }
+
+    for (size_t i = 0; i < set->capacity; i++) {
+        if (set->slots[i]) {
+            size_t j = set->slots[i] & (capacity - 1);
+            while (slots[j]) {
+                j = (j + 1) & (capacity - 1);
+            }
+            slots[j] = set->slots[i];
+        }
+    }
+
+    free(set->slots);
+    set->slots = slots;
+    set->capacity = capacity;
+    return 0;
+}
+
+// Returns 1 if the hash was added, 0 if it was already in the set, -1 if out of memory
+static int chip8_search_set_add(struct chip8_search_set* set, uint64_t hash) {
+    if ((set->count + 1) * 2 > set->capacity && chip8_search_set_grow(set) != 0) {
+        return -1;
+    }
+
+    hash = hash ? hash : 1;
+    size_t i = hash & (set->capacity - 1);
+    while (set->slots[i]) {
+        if (set->slots[i] == hash) {
+            return 0;
+        }
+        i = (i + 1) & (set->capacity - 1);
+    }
+
+    set->slots[i] = hash;
+    set->count += 1;
+    return 1;
+}
+
+// Keys only matter while a choice is held, clearing them afterwards lets states that only differ by the
+// last key pressed be recognized as duplicates
+static void chip8_search_expand(const struct chip8_search* search, const struct chip8* parent, int choice, struct chip8* child) {
+    chip8_copy(child, parent);
+    memset(child->keyboard.keyboard, 0, sizeof(child->keyboard.keyboard));
+    if (choice != CHIP8_SEARCH_NO_KEY) {
+        child->keyboard.keyboard[choice] = true;
+    }
+
+    for (int i = 0; i < search->frames_per_decision; i++) {
+        chip8_run_frame(child);
+    }
+
+    memset(child->keyboard.keyboard, 0, sizeof(child->keyboard.keyboard));
+}
+
+static void* chip8_search_worker(void* arg) {
+    struct chip8_search_chunk* chunk = arg;
+    const struct chip8_search* search = chunk->search;
+
+    for (size_t c = chunk->thread; c < chunk->count; c += chunk->threads) {
+        int choice = (int) (c % CHIP8_SEARCH_CHOICES) - 1;
+        chip8_search_expand(search, CHIP8_SEARCH_STATE(chunk->parents, chunk->stride, c / CHIP8_SEARCH_CHOICES), choice, chunk->scratch);
+        chunk->hashes[c] = chip8_hash_state(chunk->scratch);
+        chunk->goals[c] = search->goal && search->goal(chunk->scratch, search->user);
+        chip8_copy(CHIP8_SEARCH_STATE(chunk->children, chunk->stride, c), chunk->scratch);
+    }
+
+    return NULL;
+}
+
+// Emulates every child of a chunk of parents, spread over the threads
+static int chip8_search_expand_chunk(struct chip8_search* search, const unsigned char* parents, size_t count,
+    unsigned char* children, size_t stride, unsigned char* scratch, uint64_t* hashes, bool* goals, int threads) {
+    struct chip8_search_chunk chunks[threads];
+    pthread_t ids[threads];
+    int started = 0;
+
+    for (int t = 0; t < threads; t++) {
+        chunks[t].search = search;
+        chunks[t].parents = parents;
+        chunks[t].children = children;
+        chunks[t].stride = stride;
+        chunks[t].scratch = CHIP8_SEARCH_STATE(scratch, stride, t);
+        chunks[t].hashes = hashes;
+        chunks[t].goals = goals;
+        chunks[t].count = count * CHIP8_SEARCH_CHOICES;
+        chunks[t].thread = t;
+        chunks[t].threads = threads;
+    }
+
+    // The calling thread does the first share of the work itself
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&ids[t], NULL, chip8_search_worker, &chunks[t]) != 0) {
+            break;
+        }
+        started = t;
+    }
+    chip8_search_worker(&chunks[0]);
+
+    for (int t = 1; t <= started; t++) {
+        pthread_join(ids[t], NULL);
+    }
+
+    // Threads that failed to start leave their share undone, run it here so results never depend on it
+    for (int t = started + 1; t < threads; t++) {
+        chip8_search_worker(&chunks[t]);
+    }
+
+    return 0;
+}
+
+static void chip8_search_found(struct chip8_search* search, const struct chip8_search_node* nodes, size_t node, const struct chip8* state) {
+    int depth = 0;
+    for (size_t n = node; n != CHIP8_SEARCH_ROOT && nodes[n].parent != CHIP8_SEARCH_ROOT; n = nodes[n].parent) {
+        depth++;
+    }
+
+    search->found = true;
+    search->depth = depth;
+    chip8_copy(search->state, state);
+    for (size_t n = node; depth > 0; n = nodes[n].parent) {
+        search->path[--depth] = nodes[n].choice;
+    }
+}
+
+int chip8_search_run(struct chip8_search* search, const struct chip8* root) {
+    int threads = search->threads;
+    if (threads <= 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cores > 0 ? cores : 1;
+    }
+
+    int max_depth = search->max_depth < CHIP8_SEARCH_MAX_DEPTH ? search->max_depth : CHIP8_SEARCH_MAX_DEPTH;
+    size_t max_frontier = search->max_frontier ? search->max_frontier : SIZE_MAX;
+
+    search->found = false;
+    search->depth = 0;
+    search->explored = 0;
+    search->duplicates = 0;
+
+    struct chip8_search_set seen = { NULL, 0, 0 };
+    struct chip8_search_node* nodes = NULL;
+    size_t node_count = 0;
+    size_t node_capacity = 0;
+
+    // Frontier being expanded and the one being built, with the node of each state
+    size_t stride = (chip8_size(root) + _Alignof(struct chip8) - 1) / _Alignof(struct chip8) * _Alignof(struct chip8);
+    unsigned char* frontier = NULL;
+    unsigned char* next = NULL;
+    size_t* frontier_nodes = NULL;
+    size_t* next_nodes = NULL;
+    size_t frontier_count = 0;
+    size_t frontier_capacity = 0;
+    size_t next_count = 0;
+    size_t next_capacity = 0;
+
+    unsigned char* children = malloc(CHIP8_SEARCH_CHUNK * CHIP8_SEARCH_CHOICES * stride);
+    unsigned char* scratch = malloc(threads * stride);
+    uint64_t* hashes = malloc(CHIP8_SEARCH_CHUNK * CHIP8_SEARCH_CHOICES * sizeof(uint64_t));
+    bool* goals = malloc(CHIP8_SEARCH_CHUNK * CHIP8_SEARCH_CHOICES * sizeof(bool));
+    chip8_search_free(search);
+    search->state = malloc(stride);
+    int res = children && scratch && hashes && goals && search->state ? 0 : -1;
+
+    if (res == 0) {
+        frontier_capacity = 1;
+        frontier = malloc(stride);
+        frontier_nodes = malloc(sizeof(size_t));
+        nodes = malloc(sizeof(struct chip8_search_node));
+        node_capacity = 1;
+        res = frontier && frontier_nodes && nodes && chip8_search_set_add(&seen, chip8_hash_state(root)) >= 0 ? 0 : -1;
+    }
+
+    if (res == 0) {
+        chip8_copy(CHIP8_SEARCH_STATE(frontier, stride, 0), root);
+        memset(CHIP8_SEARCH_STATE(frontier, stride, 0)->keyboard.keyboard, 0, sizeof(root->keyboard.keyboard));
+        frontier_nodes[0] = 0;
+        frontier_count = 1;
+        nodes[0].parent = CHIP8_SEARCH_ROOT;
+        nodes[0].choice = CHIP8_SEARCH_NO_KEY;
+        node_count = 1;
+
+        if (search->goal && search->goal(root, search->user)) {
+            chip8_search_found(search, nodes, 0, root);
+        }
+    }
+
+    for (int depth = 0; res == 0 && !search->found && depth < max_depth && frontier_count > 0; depth++) {
+        // Room for every child of the whole frontier, bounded by max_frontier. The two frontiers trade places every
+        // depth and are only reallocated to grow, so a search settled at max_frontier allocates nothing more.
+        size_t capacity = frontier_count * CHIP8_SEARCH_CHOICES < max_frontier ? frontier_count * CHIP8_SEARCH_CHOICES : max_frontier;
+        if (capacity > next_capacity) {
+            free(next);
+            free(next_nodes);
+            next = malloc(capacity * stride);
+            next_nodes = malloc(capacity * sizeof(size_t));
+            next_capacity = capacity;
+            if (!next || !next_nodes) {
+                res = -1;
+                break;
+            }
+        }
+        next_count = 0;
+
+        for (size_t start = 0; res == 0 && !search->found && start < frontier_count; start += CHIP8_SEARCH_CHUNK) {
+            size_t count = frontier_count - start < CHIP8_SEARCH_CHUNK ? frontier_count - start : CHIP8_SEARCH_CHUNK;
+            chip8_search_expand_chunk(search, frontier + start * stride, count, children, stride, scratch, hashes, goals, threads);
+
+            for (size_t c = 0; c < count * CHIP8_SEARCH_CHOICES; c++) {
+                search->explored += 1;
+
+                int added = chip8_search_set_add(&seen, hashes[c]);
+                if (added < 0) {
+                    res = -1;
+                    break;
+                }
+                if (added == 0) {
+                    search->duplicates += 1;
+                    continue;
+                }
+
+                if (node_count == node_capacity) {
+                    node_capacity *= 2;
+                    struct chip8_search_node* more = realloc(nodes, node_capacity * sizeof(struct chip8_search_node));
+                    if (!more) {
+                        res = -1;
+                        break;
+                    }
+                    nodes = more;
+                }
+                nodes[node_count].parent = frontier_nodes[start + c / CHIP8_SEARCH_CHOICES];
+                nodes[node_count].choice = (int) (c % CHIP8_SEARCH_CHOICES) - 1;
+                node_count += 1;
+
+                if (goals[c]) {
+                    chip8_search_found(search, nodes, node_count - 1, CHIP8_SEARCH_STATE(children, stride, c));
+                    break;
+                }
+
+                if (next_count < capacity) {
+                    chip8_copy(CHIP8_SEARCH_STATE(next, stride, next_count), CHIP8_SEARCH_STATE(children, stride, c));
+                    next_nodes[next_count] = node_count - 1;
+                    next_count += 1;
+                }
+            }
+        }
+
+        // The frontier just built is expanded next
+        unsigned char* tmp = frontier;
+        size_t* tmp_nodes = frontier_nodes;
+        size_t tmp_capacity = frontier_capacity;
+        frontier = next;
+        frontier_nodes = next_nodes;
+        frontier_count = next_count;
+        frontier_capacity = next_capacity;
+        next = tmp;
+        next_nodes = tmp_nodes;
+        next_capacity = tmp_capacity;
+    }
+
+    free(seen.slots);
+    free(nodes);
+    free(frontier);
+    free(frontier_nodes);
+    free(next);
+    free(next_nodes);
+    free(children);
+    free(scratch);
+    free(hashes);
+    free(goals);
+    return res;
+}
@@ -7,17 +7,20 @@
 //      If we push the second element to the stack, the second element is indexed 1
 //      Etc...
 
-static void chip8_stack_in_bounds(struct chip8* chip8) {
+// Returns the stack slot for the stack pointer. Past either end of the stack, it wraps around and raises CHIP8_TRAP_STACK
+// instead of overwriting the rest of the chip8. Debug builds assert first, to stop right at the faulty call or return.
+static unsigned short chip8_stack_slot(struct chip8* chip8) {
     // NOTE: The Max value of the stack is 15 (Since there are 16 total addresses on the CHIP8 stack), and stack is 0-indexed
     // Also, we do not need to check if the stack pointer is < 0, since it's data type is unsigned
     assert(chip8->registers.SP < CHIP8_TOTAL_STACK_DEPTH);
+
+    chip8->trap |= chip8->registers.SP >= CHIP8_TOTAL_STACK_DEPTH ? CHIP8_TRAP_STACK : 0;
+    return chip8->registers.SP & (CHIP8_TOTAL_STACK_DEPTH - 1);
 }
 
 void chip8_stack_push(struct chip8* chip8, unsigned short val) {
-    chip8_stack_in_bounds(chip8);
-
     // Stack pointer points to the first available memory location on top of the stack, so assign the input val to that address
-    chip8->stack.stack[chip8->registers.SP] = val; 
+    chip8->stack.stack[chip8_stack_slot(chip8)] = val; 
 
     chip8->registers.SP += 1; // Increment the stack pointer
 }
@@ -25,9 +28,7 @@ void chip8_stack_push(struct chip8* chip8, unsigned short val) {
 unsigned short chip8_stack_pop(struct chip8* chip8) {
     chip8->registers.SP -= 1; // Decrement the stack pointer
 
-    chip8_stack_in_bounds(chip8);
-
-    unsigned short val = chip8->stack.stack[chip8->registers.SP]; 
+    unsigned short val = chip8->stack.stack[chip8_stack_slot(chip8)]; 
 
     return val; // Return value that was popped
-}
\ No newline at end of file
+}
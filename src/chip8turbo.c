@@ -0,0 +1,36 @@
+#include "chip8turbo.h"
+#include "config.h"
+
+void chip8_turbo_init(struct chip8_turbo* turbo, uint64_t frame_time) {
+    turbo->enabled = false;
+    turbo->frames = 1;
+    turbo->budget = frame_time * CHIP8_TURBO_BUDGET_PERCENT / 100;
+    turbo->frame_cost = 0;
+}
+
+void chip8_turbo_set(struct chip8_turbo* turbo, bool enabled) {
+    turbo->enabled = enabled;
+}
+
+int chip8_turbo_frames(const struct chip8_turbo* turbo) {
+    return turbo->enabled ? turbo->frames : 1;
+}
+
+void chip8_turbo_update(struct chip8_turbo* turbo, int frames, uint64_t elapsed) {
+    if (frames <= 0) {
+        return;
+    }
+
+    // Averaged over the last few displayed frames, so that a single slow frame (e.g. the host being busy) does not
+    // make N jump around
+    uint64_t cost = elapsed / frames;
+    turbo->frame_cost = turbo->frame_cost ? (3 * turbo->frame_cost + cost) / 4 : cost;
+
+    uint64_t fit = turbo->frame_cost ? turbo->budget / turbo->frame_cost : CHIP8_TURBO_MAX_FRAMES;
+    if (fit < 1) {
+        fit = 1;
+    } else if (fit > CHIP8_TURBO_MAX_FRAMES) {
+        fit = CHIP8_TURBO_MAX_FRAMES;
+    }
+    turbo->frames = fit;
+}
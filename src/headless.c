@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "chip8.h"
+#include "chip8hash.h"
+#include "chip8input.h"
+#include "chip8rom.h"
+#include "chip8runahead.h"
+#include "chip8savestate.h"
+
+// Headless runner: Emulates a ROM for a fixed number of frames without any window, keyboard or sound.
+// Used for regression checks (Per-frame state hashes) and for timing the core.
+// Usage: headless <rom> [--frames n] [--input file] [--seed n] [--hash-out file] [--load-state file] [--save-state file] [--runahead n]
+//                 [--quirks profile]
+
+static void usage(void) {
+    printf("Usage: headless <rom> [--frames n] [--input file] [--seed n] [--hash-out file] [--load-state file] [--save-state file] [--runahead n] "
+        "[--quirks profile]\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return -1;
+    }
+
+    const char* filename = argv[1];
+    const char* input_filename = NULL;
+    const char* hash_filename = NULL;
+    const char* load_state_filename = NULL;
+    const char* save_state_filename = NULL;
+    unsigned long frames = 3600;
+    unsigned int seed = CHIP8_DEFAULT_RNG_SEED;
+    int runahead_frames = 0;
+    const struct chip8_quirk_profile* profile = chip8_quirk_profile_find("default");
+
+    for (int i = 2; i < argc; i++) {
+        if (i + 1 >= argc) {
+            usage();
+            return -1;
+        }
+
+        if (strcmp(argv[i], "--frames") == 0) {
+            frames = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--input") == 0) {
+            input_filename = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            seed = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--hash-out") == 0) {
+            hash_filename = argv[++i];
+        } else if (strcmp(argv[i], "--load-state") == 0) {
+            load_state_filename = argv[++i];
+        } else if (strcmp(argv[i], "--save-state") == 0) {
+            save_state_filename = argv[++i];
+        } else if (strcmp(argv[i], "--runahead") == 0) {
+            runahead_frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--quirks") == 0) {
+            profile = chip8_quirk_profile_find(argv[++i]);
+            if (!profile) {
+                printf("Unknown quirk profile %s\n", argv[i]);
+                return -1;
+            }
+        } else {
+            usage();
+            return -1;
+        }
+    }
+
+    struct chip8_rom rom;
+    if (chip8_rom_open(&rom, filename) != 0) {
+        printf("Failed to open file\n");
+        return -1;
+    }
+
+    struct chip8_input_script input;
+    if (input_filename && chip8_input_script_load(&input, input_filename) != 0) {
+        printf("Failed to read input script %s\n", input_filename);
+        return -1;
+    }
+
+    FILE* hash_out = NULL;
+    if (hash_filename) {
+        hash_out = fopen(hash_filename, "w");
+        if (!hash_out) {
+            printf("Failed to open %s\n", hash_filename);
+            return -1;
+        }
+    }
+
+    // Room for XO-CHIP memory whatever the profile, a save state loaded below may select it
+    struct chip8* chip8 = chip8_new(CHIP8_XO_MEMORY_SIZE);
+    if (!chip8) {
+        printf("Out of memory\n");
+        return -1;
+    }
+    chip8_set_quirks(chip8, profile->quirks);
+    if (chip8_load(chip8, rom.data, rom.size) != 0) {
+        printf("%s does not fit in memory (%zu bytes)\n", filename, rom.size);
+        return -1;
+    }
+    chip8_seed(chip8, seed);
+    chip8_rom_close(&rom);
+
+    static unsigned char state[CHIP8_SAVE_STATE_SIZE];
+    if (load_state_filename) {
+        FILE* sf = fopen(load_state_filename, "rb");
+        size_t state_size = sf ? fread(state, 1, sizeof(state), sf) : 0;
+        if (sf) {
+            fclose(sf);
+        }
+
+        if (chip8_load_state(chip8, state, state_size) != 0) {
+            printf("Failed to load state from %s\n", load_state_filename);
+            return -1;
+        }
+    }
+
+    // Run-ahead does not change the emulated state, only the host cost per frame, which is what is being timed here
+    static struct chip8_runahead runahead;
+    if (chip8_runahead_init(&runahead, runahead_frames) != 0) {
+        printf("Out of memory\n");
+        return -1;
+    }
+
+    clock_t start = clock();
+    for (unsigned long frame = 0; frame < frames; frame++) {
+        if (input_filename) {
+            chip8_input_script_apply(&input, &chip8->keyboard, frame);
+        }
+
+        chip8_runahead_frame(&runahead, chip8);
+
+        if (hash_out) {
+            chip8_hash_stream_write(hash_out, frame, chip8_hash_state(chip8));
+        }
+    }
+    double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    printf("%s: %lu frames, %lu instructions, %.3f s, final hash %016llx\n", filename, frames, chip8->cycles, seconds,
+        (unsigned long long) chip8_hash_state(chip8));
+    if (chip8->trap) {
+        printf("%s: ROM accessed memory or the stack out of range (trap 0x%02x)\n", filename, chip8->trap);
+    }
+
+    if (hash_out) {
+        fclose(hash_out);
+    }
+
+    if (save_state_filename) {
+        size_t state_size = chip8_save_state(chip8, state, sizeof(state));
+        FILE* sf = fopen(save_state_filename, "wb");
+        if (!sf || fwrite(state, state_size, 1, sf) != 1) {
+            printf("Failed to save state to %s\n", save_state_filename);
+            return -1;
+        }
+        fclose(sf);
+    }
+
+    if (input_filename) {
+        chip8_input_script_free(&input);
+    }
+    chip8_runahead_free(&runahead);
+    free(chip8);
+
+    return 0;
+}
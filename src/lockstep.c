@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "chip8.h"
+#include "chip8engine.h"
+#include "chip8input.h"
+#include "chip8lockstep.h"
+#include "chip8rom.h"
+
+// Differential runner: Executes a ROM on two engines at once and reports the first instruction where they disagree.
+// Usage: lockstep <rom> [--engine name] [--against name] [--frames n] [--block n] [--input file] [--seed n] [--quirks profile]
+
+static void usage(void) {
+    printf("Usage: lockstep <rom> [--engine name] [--against name] [--frames n] [--block n] [--input file] [--seed n] [--quirks profile]\n");
+    printf("Engines:");
+    for (int i = 0; chip8_engine_get(i); i++) {
+        printf(" %s", chip8_engine_get(i)->name);
+    }
+    printf("\nQuirk profiles:");
+    for (int i = 0; chip8_quirk_profile_get(i); i++) {
+        printf(" %s", chip8_quirk_profile_get(i)->name);
+    }
+    printf("\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return -1;
+    }
+
+    const char* filename = argv[1];
+    const char* engine_name = "reference";
+    const char* against_name = "reference";
+    const char* input_filename = NULL;
+    unsigned long frames = 3600;
+    int block = 1;
+    unsigned int seed = CHIP8_DEFAULT_RNG_SEED;
+    const struct chip8_quirk_profile* profile = chip8_quirk_profile_find("default");
+
+    for (int i = 2; i < argc; i++) {
+        if (i + 1 >= argc) {
+            usage();
+            return -1;
+        }
+
+        if (strcmp(argv[i], "--engine") == 0) {
+            engine_name = argv[++i];
+        } else if (strcmp(argv[i], "--against") == 0) {
+            against_name = argv[++i];
+        } else if (strcmp(argv[i], "--frames") == 0) {
+            frames = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--block") == 0) {
+            block = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--input") == 0) {
+            input_filename = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            seed = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--quirks") == 0) {
+            profile = chip8_quirk_profile_find(argv[++i]);
+            if (!profile) {
+                printf("Unknown quirk profile %s\n", argv[i]);
+                usage();
+                return -1;
+            }
+        } else {
+            usage();
+            return -1;
+        }
+    }
+
+    const struct chip8_engine* engine = chip8_engine_find(engine_name);
+    const struct chip8_engine* against = chip8_engine_find(against_name);
+    if (!engine || !against) {
+        printf("Unknown engine\n");
+        usage();
+        return -1;
+    }
+
+    struct chip8_rom rom;
+    if (chip8_rom_open(&rom, filename) != 0) {
+        printf("Failed to open file\n");
+        return -1;
+    }
+
+    struct chip8_input_script input;
+    if (input_filename && chip8_input_script_load(&input, input_filename) != 0) {
+        printf("Failed to read input script %s\n", input_filename);
+        return -1;
+    }
+
+    struct chip8* chip8 = chip8_new(profile->quirks & CHIP8_QUIRK_XO_CHIP ? CHIP8_XO_MEMORY_SIZE : CHIP8_MEMORY_SIZE);
+    if (!chip8) {
+        printf("Out of memory\n");
+        return -1;
+    }
+    chip8_set_quirks(chip8, profile->quirks);
+    if (chip8_load(chip8, rom.data, rom.size) != 0) {
+        printf("%s does not fit in memory (%zu bytes)\n", filename, rom.size);
+        return -1;
+    }
+    chip8_seed(chip8, seed);
+    chip8_rom_close(&rom);
+
+    static struct chip8_lockstep_result result;
+    int diverged = chip8_lockstep_run(chip8, against, engine, input_filename ? &input : NULL, frames, block, &result);
+    free(chip8);
+    if (diverged < 0) {
+        printf("Out of memory\n");
+        return -1;
+    }
+    chip8_lockstep_report(&result, against, engine, stdout);
+    chip8_lockstep_free(&result);
+
+    if (input_filename) {
+        chip8_input_script_free(&input);
+    }
+
+    return diverged ? 1 : 0;
+}
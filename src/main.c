@@ -1,11 +1,21 @@
 #include<stdio.h>
 #include <stdbool.h>
-#include <windows.h>
-#include "SDL2/SDL.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "SDL.h"
 #include "chip8.h"
 #include "config.h"
 #include "chip8keyboard.h"
 #include "chip8screen.h"
+#include "chip8rewind.h"
+#include "chip8rom.h"
+#include "chip8pack.h"
+#include "chip8runahead.h"
+#include "chip8idle.h"
+#include "chip8turbo.h"
+#include "chip8platform.h"
+#include "chip8audio.h"
 
 const char keyboard_map[CHIP8_TOTAL_KEYS] = {
     SDLK_0, SDLK_1, SDLK_2, SDLK_3, SDLK_4, SDLK_5,
@@ -13,41 +23,189 @@ const char keyboard_map[CHIP8_TOTAL_KEYS] = {
     SDLK_c, SDLK_d, SDLK_e, SDLK_f
 };
 
+// Applies an SDL event to the emulator. Returns false when the window is closed.
+static bool handle_event(const SDL_Event* event, struct chip8* chip8, struct chip8_turbo* turbo, bool* rewinding, bool* redraw) {
+    switch(event->type) {
+        case SDL_QUIT:
+            return false;
+
+        case SDL_WINDOWEVENT:
+            // The window contents were lost (e.g. uncovered or resized), even though the game did not change them
+            if (event->window.event == SDL_WINDOWEVENT_EXPOSED || event->window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+                *redraw = true;
+            }
+        break;
+
+        case SDL_KEYDOWN:
+        {
+            if (event->key.keysym.sym == SDLK_BACKSPACE) {
+                *rewinding = true;
+                break;
+            }
+
+            // Tab switches fast-forward on and off (Key repeats of a held Tab are ignored)
+            if (event->key.keysym.sym == SDLK_TAB) {
+                if (!event->key.repeat) {
+                    chip8_turbo_set(turbo, !turbo->enabled);
+                }
+                break;
+            }
+
+            char key = event->key.keysym.sym;
+            int vkey = chip8_keyboard_map(&chip8->keyboard, key);
+            if (vkey != -1) {
+                chip8_keyboard_down(&chip8->keyboard, vkey);
+            }
+        }
+        break;
+
+        case SDL_KEYUP:
+        {
+            if (event->key.keysym.sym == SDLK_BACKSPACE) {
+                *rewinding = false;
+                break;
+            }
+
+            char key = event->key.keysym.sym;
+            int vkey = chip8_keyboard_map(&chip8->keyboard, key);
+            if (vkey != -1) {
+                chip8_keyboard_up(&chip8->keyboard, vkey);
+            }
+        }
+        break;
+    }
+
+    return true;
+}
+
+static void draw_screen(SDL_Renderer* renderer, const struct chip8_screen* screen) {
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0); // Passing in our renderer, then setting the screen to black (Red, Blue, Green, Alpha) = 0
+    SDL_RenderClear(renderer); // Paint over the entire screen black
+
+    // Color of a pixel by the planes it is set in: Plane 0 only is white (The only color plain CHIP-8 uses)
+    static const unsigned char palette[1 << CHIP8_TOTAL_PLANES][3] = {
+        { 0, 0, 0 }, { 255, 255, 255 }, { 170, 170, 170 }, { 85, 85, 85 }
+    };
+
+    // The window stays the same size, high resolution pixels are half as big
+    int width = chip8_screen_width(screen);
+    int height = chip8_screen_height(screen);
+    int pixel_size = CHIP8_WIDTH * CHIP8_WINDOW_MULTIPLIER / width;
+    for (int x = 0; x < width; x++) {
+        for (int y = 0; y < height; y++) {
+            unsigned char color = chip8_screen_get(screen, x, y);
+            if (color) {
+                SDL_SetRenderDrawColor(renderer, palette[color][0], palette[color][1], palette[color][2], 0);
+
+                // One rectangle represents one giant pixel (Since we are scaling up for bigger screen sizes on desktop)
+                SDL_Rect r;
+                r.x = x * pixel_size;
+                r.y = y * pixel_size;
+                r.w = pixel_size;
+                r.h = pixel_size;
+                // SDL_RenderDrawRect(renderer, &r);
+                SDL_RenderFillRect(renderer, &r); // Filled pixel
+            }
+        }
+    }
+    SDL_RenderPresent(renderer);
+}
+
+// Usage: main <rom> [--runahead n] [--quirks profile]
+// ==> --runahead n emulates n frames ahead to hide the input latency of the game
+// ==> --quirks selects the interpreter, overriding the quirks of a packed ROM and the switch to XO-CHIP for large ROMs
+static void usage(void) {
+    printf("Usage: main <rom> [--runahead n] [--quirks profile]\n");
+    printf("Quirk profiles:");
+    for (int i = 0; chip8_quirk_profile_get(i); i++) {
+        printf(" %s", chip8_quirk_profile_get(i)->name);
+    }
+    printf("\n");
+}
+
 int main(int argc, char** argv) {
 
     // ----------------------- Reading into specified file from user and making our buffer -----------------------
     if (argc < 2) {
-        printf("You must provide a file to load");
+        printf("You must provide a file to load\n");
+        usage();
         return -1;
     }
 
     const char* filename = argv[1];
+    int runahead_frames = 0;
+    const struct chip8_quirk_profile* profile = NULL; // NULL = The quirks of the pack, or picked by the ROM size
+
+    for (int i = 2; i < argc; i++) {
+        if (i + 1 >= argc) {
+            usage();
+            return -1;
+        }
+
+        if (strcmp(argv[i], "--runahead") == 0) {
+            runahead_frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--quirks") == 0) {
+            profile = chip8_quirk_profile_find(argv[++i]);
+            if (!profile) {
+                printf("Unknown quirk profile %s\n", argv[i]);
+                usage();
+                return -1;
+            }
+        } else {
+            usage();
+            return -1;
+        }
+    }
     printf("Reading in file %s...\n", filename);
     
-    FILE* f = fopen(filename, "rb"); // Read binary files
-
-    if (!f) {
-        printf("Failed to open file");
+    // ----------------------- Initializing/Setup Chip8 -----------------------
+    // Room for XO-CHIP memory, the quirks are only known once the ROM is opened
+    struct chip8* chip8 = chip8_new(CHIP8_XO_MEMORY_SIZE);
+    if (!chip8) {
+        printf("Out of memory\n");
         return -1;
     }
 
-    fseek(f, 0, SEEK_END);      // Identifying the buffer size of the file provided from start (0) to end (SEEK_END)
-    long size = ftell(f);       // Return size of the file
-    fseek(f, 0, SEEK_SET);      // Seek back to the beginning of the file
-
-    char buf[size]; // Making our buffer
-    int res = fread(buf, size, 1, f); // Read from file
+    // <pack>:<name> runs a ROM of a pack (See chip8pack.h) with the quirks and keys stored for it
+    static struct chip8_pack_rom packed;
+    struct chip8_pack pack;
+    const char* separator = strrchr(filename, ':');
+    char pack_filename[1024];
+    snprintf(pack_filename, sizeof(pack_filename), "%.*s", separator ? (int) (separator - filename) : 0, filename);
+    if (separator && chip8_pack_open(&pack, pack_filename) == 0) {
+        if (chip8_pack_find_name(&pack, separator + 1, &packed) != 0) {
+            printf("There is no ROM named %s in %s", separator + 1, pack_filename);
+            return -1;
+        }
+        chip8_set_quirks(chip8, profile ? profile->quirks : packed.quirks);
+        if (chip8_load(chip8, packed.data, packed.size) != 0) {
+            printf("The ROM is too large (%zu bytes) for its quirks", packed.size);
+            return -1;
+        }
+        chip8_pack_close(&pack);
+        chip8_keyboard_set_map(&chip8->keyboard, packed.keys);
+    } else {
+        // The ROM is mapped into memory rather than read into a buffer, chip8_load copies straight out of it
+        struct chip8_rom rom;
+        if (chip8_rom_open(&rom, filename) != 0) {
+            printf("Failed to open file");
+            return -1;
+        }
 
-    if (res != 1) {
-        printf("Failed to read from file");
-        return -1;
+        if (profile) {
+            chip8_set_quirks(chip8, profile->quirks);
+        } else if (rom.size > CHIP8_MEMORY_SIZE - CHIP8_PROGRAM_LOAD_ADDRESS) {
+            // Only XO-CHIP has room for ROMs this large
+            chip8_set_quirks(chip8, chip8_quirk_profile_find("xochip")->quirks);
+        }
+        if (chip8_load(chip8, rom.data, rom.size) != 0) {
+            printf("The ROM is too large (%zu bytes) for the %s profile", rom.size, profile ? profile->name : "xochip");
+            return -1;
+        }
+        chip8_rom_close(&rom);
+        chip8_keyboard_set_map(&chip8->keyboard, keyboard_map);
     }
-
-    // ----------------------- Initializing/Setup Chip8 -----------------------
-    struct chip8 chip8;
-    chip8_init(&chip8);
-    chip8_load(&chip8, buf, size);
-    chip8_keyboard_set_map(&chip8.keyboard, keyboard_map);
+    chip8_seed(chip8, time(NULL)); // Players should get different random numbers every time they play
 
     // ----------------------- Create SDL Window -----------------------
     SDL_Init(SDL_INIT_EVERYTHING); // Initalize everything with SDL
@@ -61,78 +219,110 @@ int main(int argc, char** argv) {
     
     SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_TEXTUREACCESS_TARGET);
 
-    // ----------------------- Running the program (Infinite Loop) -----------------------
-    while(1) {
-        SDL_Event event;
+    static struct chip8_audio audio;
+    if (chip8_audio_open(&audio) != 0) {
+        printf("Failed to open an audio device, running without sound: %s\n", SDL_GetError());
+    }
 
-        // Event Handling
-        while(SDL_PollEvent(&event)) {
-            switch(event.type) {
-                case SDL_QUIT:
-                    goto out;
-                break;
+    // Holding backspace rewinds the game one frame at a time
+    static struct chip8_rewind rewind;
+    chip8_rewind_init(&rewind, CHIP8_REWIND_BUDGET, CHIP8_REWIND_KEYFRAME_INTERVAL);
+    bool rewinding = false;
 
-                case SDL_KEYDOWN:
-                {
-                    char key = event.key.keysym.sym;
-                    int vkey = chip8_keyboard_map(&chip8.keyboard, key);
-                    if (vkey != -1) {
-                        chip8_keyboard_down(&chip8.keyboard, vkey);
-                    }
-                }
+    static struct chip8_runahead runahead;
+    if (chip8_runahead_init(&runahead, runahead_frames) != 0) {
+        printf("Out of memory\n");
+        return -1;
+    }
+
+    // Every frame has a fixed deadline, one 60th of a second after the previous one
+    const uint64_t frame_time = CHIP8_NANOSECONDS_PER_SECOND / CHIP8_FRAMES_PER_SECOND;
+    uint64_t deadline = chip8_platform_now();
+
+    // Tab fast-forwards, e.g. through long attract sequences
+    static struct chip8_turbo turbo;
+    chip8_turbo_init(&turbo, frame_time);
+
+    // The window is only drawn again when the picture changes, or when the window system asks for it
+    static struct chip8_screen drawn;
+    bool redraw = true;
+
+    // ----------------------- Running the program (Infinite Loop) -----------------------
+    while(1) {
+        // ----------------------- Event Handling, until the next frame is due -----------------------
+        // The loop blocks in SDL until an event comes in or the frame is due, rather than spinning. While the game is
+        // stuck in an idle loop with its timers stopped (e.g. Fx0A waiting for a key), frames would change nothing,
+        // so it blocks until an event comes in, however long that takes.
+        for (;;) {
+            bool waiting = !rewinding && chip8_idle_waiting(chip8);
+            uint64_t now = chip8_platform_now();
+            if (!waiting && now >= deadline) {
                 break;
+            }
 
-                case SDL_KEYUP:
-                {
-                    char key = event.key.keysym.sym;
-                    int vkey = chip8_keyboard_map(&chip8.keyboard, key);
-                    if (vkey != -1) {
-                        chip8_keyboard_up(&chip8.keyboard, vkey);
-                    }
-                }
+            SDL_Event event;
+            int received;
+            if (waiting) {
+                received = SDL_WaitEvent(&event);
+                deadline = chip8_platform_now(); // Whatever the event changed is emulated right away
+            } else if (deadline - now < CHIP8_NANOSECONDS_PER_SECOND / 1000) {
+                chip8_platform_sleep_until(deadline); // SDL only waits whole milliseconds, the rest is slept precisely
                 break;
+            } else {
+                received = SDL_WaitEventTimeout(&event, (deadline - now) / (CHIP8_NANOSECONDS_PER_SECOND / 1000));
             }
-        }
 
-        // ----------------------- Drawing pixels to the screen with renderer -----------------------
+            if (received && !handle_event(&event, chip8, &turbo, &rewinding, &redraw)) {
+                goto out;
+            }
 
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0); // Passing in our renderer, then setting the screen to black (Red, Blue, Green, Alpha) = 0
-        SDL_RenderClear(renderer); // Paint over the entire screen black
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 0); // Setting renderer to white so our rectangle is also white
-
-        for (int x = 0; x < CHIP8_WIDTH; x++) {
-            for (int y = 0; y < CHIP8_HEIGHT; y++) {
-                if (chip8_screen_is_set(&chip8.screen, x, y)) {
-                    // One rectangle represents one giant pixel (Since we are scaling up for bigger screen sizes on desktop)
-                    SDL_Rect r;
-                    r.x = x * CHIP8_WINDOW_MULTIPLIER;
-                    r.y = y * CHIP8_WINDOW_MULTIPLIER;
-                    r.w = CHIP8_WINDOW_MULTIPLIER;
-                    r.h = CHIP8_WINDOW_MULTIPLIER;
-                    // SDL_RenderDrawRect(renderer, &r);
-                    SDL_RenderFillRect(renderer, &r); // Filled white pixel
-                }
+            if (redraw && waiting) {
+                draw_screen(renderer, &drawn);
+                redraw = false;
             }
         }
-        SDL_RenderPresent(renderer);
 
-        if (chip8.registers.delay_timer > 0) {
-            Sleep(1);
-            chip8.registers.delay_timer -= 1;
+        // ----------------------- Emulating one frame (Or stepping back one frame) -----------------------
+        if (rewinding) {
+            // Keys currently held by the player win over the ones stored in the snapshot
+            struct chip8_keyboard keyboard = chip8->keyboard;
+            chip8_rewind_pop(&rewind, chip8);
+            chip8->keyboard = keyboard;
+            runahead.screen = chip8->screen;
+        } else {
+            // Fast-forwarding emulates several frames, of which only the last one is displayed (And stored for rewinding)
+            int frames = chip8_turbo_frames(&turbo);
+            uint64_t start = chip8_platform_now();
+            for (int i = 1; i < frames; i++) {
+                chip8_run_frame(chip8);
+            }
+            chip8_rewind_push(&rewind, chip8);
+            chip8_runahead_frame(&runahead, chip8);
+            chip8_turbo_update(&turbo, frames, chip8_platform_now() - start);
         }
 
-        if (chip8.registers.sound_timer > 0) {
-            Beep(1500, 10 * chip8.registers.sound_timer);
-            chip8.registers.sound_timer = 0;
+        // ----------------------- Drawing pixels to the screen with renderer -----------------------
+        if (redraw || !chip8_screen_equal(&drawn, &runahead.screen)) {
+            drawn = runahead.screen;
+            draw_screen(renderer, &drawn);
+            redraw = false;
         }
 
-        // Read 2 bytes from memory from where the program counter is pointing to (Opcode), then execute opcode
-        unsigned short opcode = chip8_memory_get_short(&chip8.memory, chip8.registers.PC);
-        chip8.registers.PC += 2; // Increasing program counter by 2 to read the next 2 bytes in the loop
-        chip8_exec(&chip8, opcode);
+        // The sound plays for as long as the sound timer runs, and is silent while rewinding or fast-forwarding
+        chip8_audio_update(&audio, chip8, rewinding || turbo.enabled);
+
+        deadline += frame_time;
+        uint64_t now = chip8_platform_now();
+        if (now > deadline + frame_time) {
+            deadline = now; // More than a frame behind (e.g. the window was being dragged), carry on from now instead of catching up
+        }
     } 
 
 out:
+    chip8_audio_close(&audio);
+    chip8_rewind_free(&rewind);
+    chip8_runahead_free(&runahead);
+    free(chip8);
     SDL_DestroyWindow(window); // Deallocate this pointer
     return 0;
 }
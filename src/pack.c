@@ -0,0 +1,180 @@
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "chip8.h"
+#include "chip8pack.h"
+#include "chip8rom.h"
+
+// Packs every ROM of a directory into one pack (See chip8pack.h), or lists the ROMs of a pack.
+// The metadata comes from an optional file, one ROM per line: <name> <quirk profile> <instructions per second> [keys]
+// ==> keys are the host keys of CHIP8 keys 0 - F, e.g. 0123456789abcdef (The default)
+// ==> ROMs that are not listed get the default profile, keys, and CHIP8_CYCLES_PER_FRAME instructions per frame
+// ==> Lines starting with # are comments
+// Usage: pack <rom directory> <pack> [--meta file]
+//        pack --list <pack>
+
+static const char default_keys[CHIP8_TOTAL_KEYS + 1] = "0123456789abcdef";
+
+static void usage(void) {
+    printf("Usage: pack <rom directory> <pack> [--meta file]\n");
+    printf("       pack --list <pack>\n");
+}
+
+static int compare_names(const void* a, const void* b) {
+    return strcmp(*(char* const*) a, *(char* const*) b);
+}
+
+// Fills in the metadata of every ROM listed in the metadata file
+static int read_meta(const char* filename, struct chip8_pack_rom* roms, size_t count) {
+    FILE* f = fopen(filename, "r");
+    if (!f) {
+        return -1;
+    }
+
+    char line[1024];
+    while (fgets(line, sizeof(line), f)) {
+        char name[512];
+        char profile_name[64];
+        unsigned int ips;
+        char keys[64] = "";
+        if (line[0] == '#' || sscanf(line, "%511s %63s %u %63s", name, profile_name, &ips, keys) < 3) {
+            continue;
+        }
+
+        const struct chip8_quirk_profile* profile = chip8_quirk_profile_find(profile_name);
+        if (!profile || (keys[0] && strlen(keys) != CHIP8_TOTAL_KEYS)) {
+            printf("Invalid metadata for %s\n", name);
+            fclose(f);
+            return -1;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            if (strcmp(roms[i].name, name) == 0) {
+                roms[i].quirks = profile->quirks;
+                roms[i].ips = ips;
+                if (keys[0]) {
+                    memcpy(roms[i].keys, keys, CHIP8_TOTAL_KEYS);
+                }
+            }
+        }
+    }
+
+    fclose(f);
+    return 0;
+}
+
+static int list(const char* filename) {
+    struct chip8_pack pack;
+    if (chip8_pack_open(&pack, filename) != 0) {
+        printf("Failed to open pack %s\n", filename);
+        return -1;
+    }
+
+    for (size_t i = 0; i < pack.count; i++) {
+        struct chip8_pack_rom rom;
+        if (chip8_pack_get(&pack, i, &rom) != 0) {
+            printf("Entry %zu is corrupt\n", i);
+            chip8_pack_close(&pack);
+            return -1;
+        }
+
+        const char* profile_name = "custom";
+        for (int p = 0; chip8_quirk_profile_get(p); p++) {
+            if (chip8_quirk_profile_get(p)->quirks == rom.quirks) {
+                profile_name = chip8_quirk_profile_get(p)->name;
+                break;
+            }
+        }
+
+        printf("%016llx %6zu %-8s %5u %.*s %s\n", (unsigned long long) rom.hash, rom.size, profile_name, rom.ips,
+            CHIP8_TOTAL_KEYS, rom.keys, rom.name);
+    }
+
+    chip8_pack_close(&pack);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 3 && strcmp(argv[1], "--list") == 0) {
+        return list(argv[2]);
+    }
+
+    if (argc != 3 && !(argc == 5 && strcmp(argv[3], "--meta") == 0)) {
+        usage();
+        return -1;
+    }
+
+    const char* dirname = argv[1];
+    const char* filename = argv[2];
+    const char* meta_filename = argc == 5 ? argv[4] : NULL;
+
+    DIR* dir = opendir(dirname);
+    if (!dir) {
+        printf("Failed to open directory %s\n", dirname);
+        return -1;
+    }
+
+    // Sorted, so packing the same directory always gives the same pack
+    char** names = NULL;
+    size_t count = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir))) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+
+        char** more = realloc(names, (count + 1) * sizeof(char*));
+        if (!more) {
+            printf("Out of memory\n");
+            return -1;
+        }
+        names = more;
+        names[count++] = strdup(entry->d_name);
+    }
+    closedir(dir);
+    qsort(names, count, sizeof(char*), compare_names);
+
+    struct chip8_rom* files = calloc(count ? count : 1, sizeof(struct chip8_rom));
+    struct chip8_pack_rom* roms = calloc(count ? count : 1, sizeof(struct chip8_pack_rom));
+    if (!files || !roms) {
+        printf("Out of memory\n");
+        return -1;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/%s", dirname, names[i]);
+        if (chip8_rom_open(&files[i], path) != 0) {
+            printf("Failed to open ROM %s\n", path);
+            return -1;
+        }
+
+        roms[i].name = names[i];
+        roms[i].data = files[i].data;
+        roms[i].size = files[i].size;
+        roms[i].quirks = chip8_quirk_profile_find("default")->quirks;
+        roms[i].ips = CHIP8_CYCLES_PER_FRAME * CHIP8_FRAMES_PER_SECOND;
+        memcpy(roms[i].keys, default_keys, CHIP8_TOTAL_KEYS);
+    }
+
+    if (meta_filename && read_meta(meta_filename, roms, count) != 0) {
+        printf("Failed to read metadata from %s\n", meta_filename);
+        return -1;
+    }
+
+    if (chip8_pack_write(filename, roms, count) != 0) {
+        printf("Failed to write pack %s\n", filename);
+        return -1;
+    }
+    printf("Packed %zu ROMs into %s\n", count, filename);
+
+    for (size_t i = 0; i < count; i++) {
+        chip8_rom_close(&files[i]);
+        free(names[i]);
+    }
+    free(names);
+    free(files);
+    free(roms);
+    return 0;
+}
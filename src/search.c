@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "chip8.h"
+#include "chip8rom.h"
+#include "chip8savestate.h"
+#include "chip8search.h"
+
+// Searches for the shortest sequence of key presses that reaches a goal, then writes it out as an input script
+// that the headless runner can replay (With the same --load-state, if one was given).
+// Goals: --goal-pc addr (The program counter reaches addr) or --goal-mem addr value (A memory byte equals value)
+// Usage: search <rom> (--goal-pc addr | --goal-mem addr value) [--load-state file] [--depth n] [--frames n]
+//               [--frontier n] [--threads n] [--out file]
+
+struct search_goal {
+    int pc;
+    int address;
+    int value;
+};
+
+static bool search_goal_reached(const struct chip8* chip8, void* user) {
+    const struct search_goal* goal = user;
+    if (goal->pc >= 0 && chip8->registers.PC == goal->pc) {
+        return true;
+    }
+    return goal->address >= 0 && chip8->memory.memory[goal->address] == goal->value;
+}
+
+static void usage(void) {
+    printf("Usage: search <rom> (--goal-pc addr | --goal-mem addr value) [--load-state file] [--depth n] [--frames n] "
+        "[--frontier n] [--threads n] [--out file]\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return -1;
+    }
+
+    struct search_goal goal = { -1, -1, 0 };
+    struct chip8_search search;
+    chip8_search_init(&search, search_goal_reached, &goal);
+    const char* load_state_filename = NULL;
+    const char* out_filename = NULL;
+
+    for (int i = 2; i < argc; i++) {
+        if (i + 1 >= argc) {
+            usage();
+            return -1;
+        }
+
+        if (strcmp(argv[i], "--goal-pc") == 0) {
+            goal.pc = strtol(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--goal-mem") == 0 && i + 2 < argc) {
+            goal.address = strtol(argv[++i], NULL, 0) % CHIP8_XO_MEMORY_SIZE;
+            goal.value = strtol(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--load-state") == 0) {
+            load_state_filename = argv[++i];
+        } else if (strcmp(argv[i], "--depth") == 0) {
+            search.max_depth = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--frames") == 0) {
+            search.frames_per_decision = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--frontier") == 0) {
+            search.max_frontier = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            search.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--out") == 0) {
+            out_filename = argv[++i];
+        } else {
+            usage();
+            return -1;
+        }
+    }
+
+    if (goal.pc < 0 && goal.address < 0) {
+        usage();
+        return -1;
+    }
+
+    struct chip8_rom rom;
+    if (chip8_rom_open(&rom, argv[1]) != 0) {
+        printf("Failed to open file\n");
+        return -1;
+    }
+
+    // Room for XO-CHIP memory, in case the save state loaded below selects it
+    struct chip8* chip8 = chip8_new(CHIP8_XO_MEMORY_SIZE);
+    if (!chip8) {
+        printf("Out of memory\n");
+        return -1;
+    }
+    if (chip8_load(chip8, rom.data, rom.size) != 0) {
+        printf("%s does not fit in memory (%zu bytes)\n", argv[1], rom.size);
+        return -1;
+    }
+    chip8_rom_close(&rom);
+
+    if (load_state_filename) {
+        static unsigned char state[CHIP8_SAVE_STATE_SIZE];
+        FILE* sf = fopen(load_state_filename, "rb");
+        size_t state_size = sf ? fread(state, 1, sizeof(state), sf) : 0;
+        if (sf) {
+            fclose(sf);
+        }
+
+        if (chip8_load_state(chip8, state, state_size) != 0) {
+            printf("Failed to load state from %s\n", load_state_filename);
+            return -1;
+        }
+    }
+
+    int res = chip8_search_run(&search, chip8);
+    chip8_search_free(&search); // Only the path is written out
+    free(chip8);
+    if (res != 0) {
+        printf("Search failed (Out of memory)\n");
+        return -1;
+    }
+
+    printf("%s after %zu states (%zu duplicates)\n", search.found ? "Goal reached" : "Goal not reached", search.explored, search.duplicates);
+    if (!search.found) {
+        return 1;
+    }
+
+    // Each decision holds its key for frames_per_decision frames, then releases it
+    FILE* out = out_filename ? fopen(out_filename, "w") : stdout;
+    if (!out) {
+        printf("Failed to open %s\n", out_filename);
+        return -1;
+    }
+
+    fprintf(out, "# %d decisions of %d frames\n", search.depth, search.frames_per_decision);
+    for (int d = 0; d < search.depth; d++) {
+        if (search.path[d] == CHIP8_SEARCH_NO_KEY) {
+            continue;
+        }
+        unsigned long frame = (unsigned long) d * search.frames_per_decision;
+        fprintf(out, "%lu %x d\n", frame, search.path[d]);
+        fprintf(out, "%lu %x u\n", frame + search.frames_per_decision, search.path[d]);
+    }
+
+    if (out != stdout) {
+        fclose(out);
+    }
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "chip8hash.h"
+#include "chip8job.h"
+#include "chip8sched.h"
+
+// Runs every job of a job file (See chip8job.h) on all cores, then prints one line per job:
+// <rom> <frames> <instructions> <final state hash>
+// Usage: sweep <jobfile> [--threads n]
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printf("Usage: sweep <jobfile> [--threads n]\n");
+        return -1;
+    }
+
+    int threads = 0;
+    if (argc >= 4 && strcmp(argv[2], "--threads") == 0) {
+        threads = atoi(argv[3]);
+    }
+
+    struct chip8_job* jobs;
+    size_t count;
+    if (chip8_jobs_load(argv[1], &jobs, &count) != 0) {
+        printf("Failed to load jobs from %s\n", argv[1]);
+        return -1;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (chip8_sched_run(jobs, count, threads) != 0) {
+        printf("Failed to start worker threads\n");
+        return -1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    for (size_t i = 0; i < count; i++) {
+        printf("%s %lu %lu %016llx\n", jobs[i].rom, jobs[i].frame, jobs[i].chip8->cycles,
+            (unsigned long long) chip8_hash_state(jobs[i].chip8));
+    }
+
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    fprintf(stderr, "%zu jobs in %.3f s\n", count, seconds);
+
+    chip8_jobs_free(jobs, count);
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "chip8.h"
+#include "chip8engine.h"
+
+// Runs a SUPER-CHIP ROM on every engine with the quirks picked by profile name, the way --quirks picks them.
+// Exits with 0 if the schip profile switches to high resolution and draws past the low resolution screen, and the
+// default profile ignores 00FF.
+
+// 00FF 6078 613C A000 D015 120A: High resolution, then the font's 0 at (120, 60), then loops
+static const unsigned char rom[] = { 0x00, 0xFF, 0x60, 0x78, 0x61, 0x3C, 0xA0, 0x00, 0xD0, 0x15, 0x12, 0x0A };
+
+// Returns 0 if the engine ends up in the expected resolution, 1 if not, -1 if it does not run these quirks
+static int check(const struct chip8_engine* engine, struct chip8* chip8, const char* profile_name, bool hires) {
+    chip8_init(chip8);
+    chip8_set_quirks(chip8, chip8_quirk_profile_find(profile_name)->quirks);
+    chip8_load(chip8, (const char*) rom, sizeof(rom));
+    if (engine->run(chip8, 10, engine->context) <= 0) {
+        return -1;
+    }
+
+    // (120, 60) is only on screen in high resolution, low resolution wraps the sprite around to (56, 28)
+    if (chip8->screen.hires != hires || (hires && !chip8_screen_is_set(&chip8->screen, 120, 60)) ||
+        (!hires && !chip8_screen_is_set(&chip8->screen, 56, 28))) {
+        printf("%s, %s profile: hires=%d, sprite not where expected\n", engine->name, profile_name, chip8->screen.hires);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void) {
+    struct chip8* chip8 = chip8_new(CHIP8_MEMORY_SIZE);
+    if (!chip8) {
+        printf("schip: Out of memory\n");
+        return 1;
+    }
+
+    int failed = 0;
+    for (int i = 0; chip8_engine_get(i); i++) {
+        const struct chip8_engine* engine = chip8_engine_get(i);
+        // Engines limited to plain CHIP-8 (e.g. the pool) refuse the schip quirks rather than run them differently
+        if (check(engine, chip8, "schip", true) > 0 || check(engine, chip8, "default", false) > 0) {
+            failed = 1;
+        }
+    }
+
+    free(chip8);
+    printf("%s\n", failed ? "schip: FAILED" : "schip: ok");
+    return failed;
+}